@@ -1,16 +1,17 @@
 #include "Brawler.h"
+#include "TBSCombatTables.h"
 
 ABrawler::ABrawler()
 {
     // Brawler stats
     UnitType = EUnitType::BRAWLER;
     UnitName = "Brawler";
-    MovementRange = 6;
+    MovementRange = FTBSCombatTables::BRAWLER_MOVEMENT_RANGE;
     AttackType = EAttackType::MELEE;
-    AttackRange = 1;
-    MinDamage = 1;
-    MaxDamage = 6;
-    Health = 40;
-    MaxHealth = 40;
+    AttackRange = FTBSCombatTables::BRAWLER_ATTACK_RANGE;
+    MinDamage = FTBSCombatTables::BRAWLER_MIN_DAMAGE;
+    MaxDamage = FTBSCombatTables::BRAWLER_MAX_DAMAGE;
+    Health = FTBSCombatTables::BRAWLER_MAX_HEALTH;
+    MaxHealth = FTBSCombatTables::BRAWLER_MAX_HEALTH;
 
 }
\ No newline at end of file
@@ -3,7 +3,18 @@
 
 #include "Grid.h"
 #include "Kismet/GameplayStatics.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "TBS_GameMode.h"
+#include "TBSStats.h"
+#include "Unit.h"
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<int32> CVarValidateGrid(
+	TEXT("tbs.ValidateGrid"),
+	0,
+	TEXT("1 checks the grid cells changed during each turn against their tiles and repairs them, and the bitboard flood fills against the BFS"));
+#endif
 
 // Sets default values
 AGrid::AGrid()
@@ -17,6 +28,27 @@ AGrid::AGrid()
 	// tile padding percentage 
 	CellPadding = 0.12f;
 
+	// the instanced tiles are drawn relative to the grid
+	Scene = CreateDefaultSubobject<USceneComponent>(TEXT("Scene"));
+	SetRootComponent(Scene);
+
+	TileInstances = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("TileInstances"));
+	TileInstances->SetupAttachment(Scene);
+	TileInstances->SetCastShadow(false);
+
+	// clicks are picked from the cursor ray (GetCellIndexByRay), the instances need no physics bodies
+	TileInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// instanced rendering is opt-in, the tile blueprint keeps working as before
+	bInstancedTiles = false;
+	TileMesh = nullptr;
+	TileMaterial = nullptr;
+	GroundColor = FLinearColor(0.8f, 0.8f, 0.8f);
+	ObstacleColor = FLinearColor(0.1f, 0.1f, 0.1f);
+	MovementColor = FLinearColor(0.1f, 0.4f, 1.0f);
+	AttackColor = FLinearColor(1.0f, 0.15f, 0.1f);
+	SelectionColor = FLinearColor(1.0f, 0.85f, 0.1f);
+
 }
 
 void AGrid::OnConstruction(const FTransform& Transform)
@@ -30,19 +62,37 @@ void AGrid::OnConstruction(const FTransform& Transform)
 void AGrid::BeginPlay()
 {
 	Super::BeginPlay();
-	GenerateGrid();
-	ValidateAllObstacles();
+
+	// The game mode may already have generated the grid right after spawning it
+	if (Cells.Num() == 0)
+	{
+		GenerateGrid();
+	}
 
 }
 
 // Resets the grid to empty
 void AGrid::ResetGrid()
 {
+	// First, clear any highlights, only the highlighted cells are redrawn
+	for (int32 Layer = 0; Layer < NUM_HIGHLIGHT_LAYERS; Layer++)
+	{
+		ClearHighlightedCells(static_cast<ETileVisual>(static_cast<uint8>(ETileVisual::MOVEMENT) + Layer));
+	}
+
+	// Then remove the obstacles together with their look
+	ObstacleBits.ForEachSetBit([this](const int32 Index)
+		{
+			SetCellObstacle(Index, false);
+		});
+
 	// Reset all tiles to empty state
 	for (ATile* Obj : TileArray)
 	{
-		// First, clear any highlights or special materials
-		Obj->ClearHighlight();
+		if (!Obj)
+		{
+			continue;
+		}
 
 		// Then reset the tile status
 		Obj->SetTileStatus(NOT_ASSIGNED, ETileStatus::EMPTY);
@@ -51,6 +101,9 @@ void AGrid::ResetGrid()
 		Obj->SetOccupyingUnit(nullptr);
 	}
 
+	// No unit is left on the board
+	ClearUnitSlots();
+
 	// Send broadcast event to registered objects 
 	OnResetEvent.Broadcast();
 
@@ -66,33 +119,637 @@ void AGrid::ResetGrid()
 //Generates a squared (size x size) grid
 void AGrid::GenerateGrid()
 {
-	if (!TileClass)
+	if (bInstancedTiles && !TileMesh)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("bInstancedTiles needs a TileMesh, spawning the tile meshes instead."));
+	}
+
+	// Instanced tiles only need the native tile data, the grid draws them
+	const bool bInstanced = bInstancedTiles && TileMesh;
+	if (!bInstanced && !TileClass)
 	{
 		UE_LOG(LogTemp, Error, TEXT("TileClass is not set! Please assign it in the Blueprint."));
 		return;
 	}
 
-	for (int32 IndexX = 0; IndexX < Size; IndexX++)
+	// Regenerating replaces any previously spawned board
+	DestroyTiles();
+	bTilesAreInstances = bInstanced;
+
+	Cells.SetNum(Size * Size);
+	TileArray.SetNumZeroed(Size * Size);
+
+	// Every cell starts as free ground
+	ObstacleBits.Init(Size);
+	OccupiedBits.Init(Size);
+	HighlightBits.Init(Size);
+	for (FGridBitboard& LayerBits : HighlightLayers)
+	{
+		LayerBits.Init(Size);
+	}
+	HighlightRequestBits.Init(Size);
+	HighlightDiffBits.Init(Size);
+#if !UE_BUILD_SHIPPING
+	DirtyCells.Init(Size);
+#endif
+	WalkableBits.Init(Size);
+	WalkableBits.SetAll();
+	for (FGridBitboard& PlayerBits : OwnerBits)
+	{
+		PlayerBits.Init(Size);
+	}
+	ScratchBits.Init(Size);
+	FrontierBits.Init(Size);
+	BFS.Init(Size);
+	AStar.Init(Size);
+
+	// Nothing computed on the previous board applies any more
+	DistanceCache.Reset();
+	BoardVersion++;
+
+	// Instanced tiles are drawn from the cells, their actors are only spawned when asked for
+	if (bTilesAreInstances)
+	{
+		SpawnTileInstances();
+		return;
+	}
+
+	// Row-major order, so that TileArray and Cells share the same index
+	for (int32 Index = 0; Index < Size * Size; Index++)
+	{
+		// Missing tiles can't be walked on
+		if (!SpawnTile(Index, TileClass))
+		{
+			UpdateCellStatus(Index, OBSTACLE_OWNER, ETileStatus::OCCUPIED);
+		}
+	}
+}
+
+ATile* AGrid::SpawnTile(const int32 Index, const TSubclassOf<ATile> SpawnClass)
+{
+	const FIntPoint Coords = GetCellCoords(Index);
+	FVector Location = GetRelativeLocationByXYPosition(Coords.X, Coords.Y);
+
+	// Check if spawning is successful
+	ATile* Obj = GetWorld()->SpawnActor<ATile>(SpawnClass, Location, FRotator::ZeroRotator);
+	if (!Obj)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to spawn tile at (%d, %d)"), Coords.X, Coords.Y);
+		return nullptr;
+	}
+	const float TileScale = TileSize / 100.0f;
+	const float Zscaling = 0.2f;
+	Obj->SetActorScale3D(FVector(TileScale, TileScale, Zscaling));
+	Obj->SetGridPosition(Coords.X, Coords.Y);
+
+	// A tile spawned during the match mirrors its cell before binding, so binding writes back what the cell holds
+	const FGridCell& Cell = Cells[Index];
+	Obj->SetTileStatus(Cell.Owner, Cell.Status);
+	Obj->SetOccupyingUnit(GetCellUnit(Index));
+
+	Obj->BindToGrid(this, Index);
+	TileArray[Index] = Obj;
+	return Obj;
+}
+
+void AGrid::DestroyTiles()
+{
+	for (ATile* Obj : TileArray)
+	{
+		if (Obj)
+		{
+			Obj->Destroy();
+		}
+	}
+
+	TileArray.Empty();
+	ClearUnitSlots();
+	Cells.Empty();
+
+	if (TileInstances)
+	{
+		TileInstances->ClearInstances();
+	}
+	CellVisuals.Empty();
+	bTilesAreInstances = false;
+}
+
+void AGrid::SpawnTileInstances()
+{
+	const int32 NumCells = Size * Size;
+
+	TileInstances->SetStaticMesh(TileMesh);
+	if (TileMaterial)
 	{
-		for (int32 IndexY = 0; IndexY < Size; IndexY++)
+		TileInstances->SetMaterial(0, TileMaterial);
+	}
+	TileInstances->SetNumCustomDataFloats(NUM_TILE_CUSTOM_DATA);
+
+	// Same placement and scale as the tile actors
+	const float TileScale = TileSize / 100.0f;
+	const float Zscaling = 0.2f;
+
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(NumCells);
+	for (int32 IndexY = 0; IndexY < Size; IndexY++)
+	{
+		for (int32 IndexX = 0; IndexX < Size; IndexX++)
 		{
-			FVector Location = GetRelativeLocationByXYPosition(IndexX, IndexY);
+			Transforms.Emplace(FRotator::ZeroRotator, GetRelativeLocationByXYPosition(IndexX, IndexY), FVector(TileScale, TileScale, Zscaling));
+		}
+	}
+
+	// A single batch, so the instance tree is built once for the whole board
+	TileInstances->AddInstances(Transforms, false);
+
+	CellVisuals.Init(ETileVisual::GROUND, NumCells);
 
-			// Check if spawning is successful
-			ATile* Obj = GetWorld()->SpawnActor<ATile>(TileClass, Location, FRotator::ZeroRotator);
-			if (!Obj)
+	const FLinearColor& Color = GetVisualColor(ETileVisual::GROUND);
+	const float CustomData[NUM_TILE_CUSTOM_DATA] = { Color.R, Color.G, Color.B };
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		TileInstances->SetCustomData(Index, MakeArrayView(CustomData));
+	}
+	TileInstances->MarkRenderStateDirty();
+}
+
+void AGrid::SetCellVisual(const int32 Index, const ETileVisual Visual)
+{
+	if (!bTilesAreInstances || !CellVisuals.IsValidIndex(Index) || CellVisuals[Index] == Visual)
+	{
+		return;
+	}
+
+	CellVisuals[Index] = Visual;
+
+	// Marking the render state dirty is deferred to the end of the frame, a whole highlight is sent at once
+	const FLinearColor& Color = GetVisualColor(Visual);
+	const float CustomData[NUM_TILE_CUSTOM_DATA] = { Color.R, Color.G, Color.B };
+	TileInstances->SetCustomData(Index, MakeArrayView(CustomData), true);
+}
+
+const FLinearColor& AGrid::GetVisualColor(const ETileVisual Visual) const
+{
+	switch (Visual)
+	{
+	case ETileVisual::OBSTACLE:
+		return ObstacleColor;
+	case ETileVisual::MOVEMENT:
+		return MovementColor;
+	case ETileVisual::ATTACK:
+		return AttackColor;
+	case ETileVisual::SELECTION:
+		return SelectionColor;
+	default:
+		return GroundColor;
+	}
+}
+
+int32 AGrid::GetNeighbourIndex(const int32 Index, const int32 Direction) const
+{
+	const int32 X = Index % Size + FGridDirections::X[Direction];
+	const int32 Y = Index / Size + FGridDirections::Y[Direction];
+
+	return IsValidCell(X, Y) ? GetCellIndex(X, Y) : INDEX_NONE;
+}
+
+ATile* AGrid::GetTile(const int32 InX, const int32 InY)
+{
+	return IsValidCell(InX, InY) ? GetTileByIndex(GetCellIndex(InX, InY)) : nullptr;
+}
+
+ATile* AGrid::GetTileByIndex(const int32 Index)
+{
+	if (!TileArray.IsValidIndex(Index))
+	{
+		return nullptr;
+	}
+
+	// A plain ATile has no mesh, so it adds no draw call, collision or render state
+	if (!TileArray[Index] && bTilesAreInstances)
+	{
+		return SpawnTile(Index, ATile::StaticClass());
+	}
+
+	return TileArray[Index];
+}
+
+AUnit* AGrid::GetCellUnit(const int32 Index) const
+{
+	const int32 Slot = Cells[Index].UnitSlot;
+	return Slot != INDEX_NONE ? BoardUnits[Slot] : nullptr;
+}
+
+void AGrid::UpdateCellStatus(const int32 Index, const int32 TileOwner, const ETileStatus TileStatus)
+{
+	if (!Cells.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	FGridCell& Cell = Cells[Index];
+	const bool bIsObstacle = (TileOwner == OBSTACLE_OWNER);
+	const bool bWasObstacle = Cell.bObstacle;
+
+	// The tiles often write the state they already have
+	if (Cell.Status == TileStatus && Cell.Owner == TileOwner && Cell.bObstacle == bIsObstacle)
+	{
+		return;
+	}
+
+	Cell.Status = TileStatus;
+	Cell.Owner = static_cast<int8>(TileOwner);
+	Cell.bObstacle = bIsObstacle;
+	BoardVersion++;
+#if !UE_BUILD_SHIPPING
+	DirtyCells.Set(Index, true);
+#endif
+
+	UpdateCellBits(Index);
+
+	// Instanced tiles show the obstacles straight from the board state
+	if (bWasObstacle != bIsObstacle)
+	{
+		SetCellVisual(Index, bIsObstacle ? ETileVisual::OBSTACLE : ETileVisual::GROUND);
+	}
+}
+
+void AGrid::UpdateCellUnit(const int32 Index, AUnit* Unit)
+{
+	if (!Cells.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	const int32 OldSlot = Cells[Index].UnitSlot;
+	const int32 Slot = Unit ? AcquireUnitSlot(Unit, Index) : INDEX_NONE;
+	if (OldSlot == Slot)
+	{
+		return;
+	}
+
+	Cells[Index].UnitSlot = static_cast<int16>(Slot);
+	BoardVersion++;
+#if !UE_BUILD_SHIPPING
+	DirtyCells.Set(Index, true);
+#endif
+
+	UpdateCellBits(Index);
+
+	if (OldSlot != INDEX_NONE)
+	{
+		ReleaseUnitSlot(OldSlot, Index);
+	}
+}
+
+int32 AGrid::AcquireUnitSlot(AUnit* Unit, const int32 Index)
+{
+	int32 Slot = INDEX_NONE;
+	if (const int32* Found = UnitSlots.Find(Unit))
+	{
+		Slot = *Found;
+	}
+	else if (FreeUnitSlots.Num() > 0)
+	{
+		Slot = FreeUnitSlots.Pop(EAllowShrinking::No);
+		BoardUnits[Slot] = Unit;
+		UnitSlots.Add(Unit, Slot);
+	}
+	else
+	{
+		Slot = BoardUnits.Add(Unit);
+		SlotCells.Add(INDEX_NONE);
+		UnitSlots.Add(Unit, Slot);
+	}
+
+	// A moving unit keeps its slot, whichever of its two cells is written first
+	SlotCells[Slot] = Index;
+	return Slot;
+}
+
+void AGrid::ReleaseUnitSlot(const int32 Slot, const int32 Index)
+{
+	if (SlotCells[Slot] != Index)
+	{
+		return;
+	}
+
+	UnitSlots.Remove(BoardUnits[Slot]);
+	BoardUnits[Slot] = nullptr;
+	SlotCells[Slot] = INDEX_NONE;
+	FreeUnitSlots.Add(Slot);
+}
+
+void AGrid::ClearUnitSlots()
+{
+	BoardUnits.Empty();
+	UnitSlots.Empty();
+	SlotCells.Empty();
+	FreeUnitSlots.Empty();
+}
+
+int32 AGrid::GetHighlightLayer(const ETileVisual Highlight)
+{
+	const int32 Layer = static_cast<int32>(Highlight) - static_cast<int32>(ETileVisual::MOVEMENT);
+	return (Layer >= 0 && Layer < NUM_HIGHLIGHT_LAYERS) ? Layer : INDEX_NONE;
+}
+
+bool AGrid::CanHighlightCell(const int32 Index) const
+{
+	const FGridCell& Cell = Cells[Index];
+	return !Cell.bObstacle && !(Cell.Status == ETileStatus::OCCUPIED && Cell.UnitSlot == INDEX_NONE);
+}
+
+void AGrid::SetHighlightedCells(const ETileVisual Highlight, const FGridBitboard& NewCells)
+{
+	TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_HighlightUpdate);
+
+	const int32 Layer = GetHighlightLayer(Highlight);
+	if (Layer == INDEX_NONE || NewCells.GetSize() != Size)
+	{
+		return;
+	}
+
+	// Only the cells entering or leaving the layer need a redraw
+	FGridBitboard& LayerBits = HighlightLayers[Layer];
+	HighlightDiffBits = LayerBits;
+	HighlightDiffBits ^= NewCells;
+
+	HighlightDiffBits.ForEachSetBit([this, &LayerBits, &NewCells](const int32 Index)
+		{
+			const bool bHighlighted = NewCells.Get(Index) && CanHighlightCell(Index);
+			if (LayerBits.Get(Index) != bHighlighted)
 			{
-				UE_LOG(LogTemp, Error, TEXT("Failed to spawn tile at (%d, %d)"), IndexX, IndexY);
-				continue;
+				LayerBits.Set(Index, bHighlighted);
+				RedrawCellHighlight(Index);
 			}
-			const float TileScale = TileSize / 100.0f;
-			const float Zscaling = 0.2f;
-			Obj->SetActorScale3D(FVector(TileScale, TileScale, Zscaling));
-			Obj->SetGridPosition(IndexX, IndexY);
-			TileArray.Add(Obj);
-			TileMap.Add(FVector2D(IndexX, IndexY), Obj);
+		});
+}
+
+void AGrid::SetHighlightedTiles(const ETileVisual Highlight, const TArray<ATile*>& Tiles)
+{
+	HighlightRequestBits.Reset();
+	for (const ATile* Tile : Tiles)
+	{
+		if (Tile && Cells.IsValidIndex(Tile->GetCellIndex()))
+		{
+			HighlightRequestBits.Set(Tile->GetCellIndex(), true);
+		}
+	}
+
+	SetHighlightedCells(Highlight, HighlightRequestBits);
+}
+
+void AGrid::ClearHighlightedCells(const ETileVisual Highlight)
+{
+	TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_HighlightUpdate);
+
+	const int32 Layer = GetHighlightLayer(Highlight);
+	if (Layer == INDEX_NONE || HighlightLayers[Layer].IsEmpty())
+	{
+		return;
+	}
+
+	HighlightDiffBits = HighlightLayers[Layer];
+	HighlightLayers[Layer].Reset();
+
+	HighlightDiffBits.ForEachSetBit([this](const int32 Index)
+		{
+			RedrawCellHighlight(Index);
+		});
+}
+
+void AGrid::SetCellHighlight(const int32 Index, const ETileVisual Highlight, const bool bHighlighted)
+{
+	const int32 Layer = GetHighlightLayer(Highlight);
+	if (Layer == INDEX_NONE || !Cells.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	const bool bNewValue = bHighlighted && CanHighlightCell(Index);
+	if (HighlightLayers[Layer].Get(Index) != bNewValue)
+	{
+		HighlightLayers[Layer].Set(Index, bNewValue);
+		RedrawCellHighlight(Index);
+	}
+}
+
+void AGrid::ClearCellHighlights(const int32 Index)
+{
+	if (!Cells.IsValidIndex(Index) || !HighlightBits.Get(Index))
+	{
+		return;
+	}
+
+	for (FGridBitboard& LayerBits : HighlightLayers)
+	{
+		LayerBits.Set(Index, false);
+	}
+	RedrawCellHighlight(Index);
+}
+
+void AGrid::RedrawCellHighlight(const int32 Index)
+{
+	TBS_COUNTER_ADD(TBS_TilesTouched, 1);
+
+	// The topmost layer holding the cell wins
+	ETileVisual Visual = ETileVisual::GROUND;
+	for (int32 Layer = NUM_HIGHLIGHT_LAYERS - 1; Layer >= 0; Layer--)
+	{
+		if (HighlightLayers[Layer].Get(Index))
+		{
+			Visual = static_cast<ETileVisual>(static_cast<uint8>(ETileVisual::MOVEMENT) + Layer);
+			break;
 		}
 	}
+
+	HighlightBits.Set(Index, Visual != ETileVisual::GROUND);
+
+	if (bTilesAreInstances)
+	{
+		SetCellVisual(Index, (Visual == ETileVisual::GROUND && Cells[Index].bObstacle) ? ETileVisual::OBSTACLE : Visual);
+	}
+	else if (ATile* Tile = FindTileByIndex(Index))
+	{
+		Tile->DrawHighlight(Visual);
+	}
+}
+
+UFunction* AGrid::GetTileHighlightEvent(const ETileVisual Highlight)
+{
+	const int32 Layer = GetHighlightLayer(Highlight);
+	if (Layer == INDEX_NONE || !TileClass)
+	{
+		return nullptr;
+	}
+
+	ResolveTileEvents();
+	return HighlightEvents[Layer];
+}
+
+void AGrid::ResolveTileEvents()
+{
+	// A name lookup per class instead of one per highlighted tile
+	if (TileEventClass == TileClass.Get())
+	{
+		return;
+	}
+
+	static const FName EventNames[NUM_HIGHLIGHT_LAYERS] =
+	{
+		TEXT("HighlightForMovement"),
+		TEXT("HighlightForAttack"),
+		TEXT("HighlightForSelection")
+	};
+
+	for (int32 Index = 0; Index < NUM_HIGHLIGHT_LAYERS; Index++)
+	{
+		HighlightEvents[Index] = TileClass ? TileClass->FindFunctionByName(EventNames[Index]) : nullptr;
+	}
+	ObstacleEvent = TileClass ? TileClass->FindFunctionByName(TEXT("SetObstacleMaterial")) : nullptr;
+	TileEventClass = TileClass.Get();
+}
+
+void AGrid::SetCellObstacle(const int32 Index, const bool bObstacle)
+{
+	if (!Cells.IsValidIndex(Index) || Cells[Index].bObstacle == bObstacle)
+	{
+		return;
+	}
+
+	TBS_COUNTER_ADD(TBS_TilesTouched, 1);
+
+	// Obstacles are never highlighted
+	ClearCellHighlights(Index);
+
+	const int32 NewOwner = bObstacle ? OBSTACLE_OWNER : NOT_ASSIGNED;
+	const ETileStatus NewStatus = bObstacle ? ETileStatus::OCCUPIED : ETileStatus::EMPTY;
+
+	// Cells without a tile actor, e.g. on an instanced board, only change their state
+	ATile* Tile = FindTileByIndex(Index);
+	if (!Tile)
+	{
+		UpdateCellStatus(Index, NewOwner, NewStatus);
+		return;
+	}
+
+	// The tile passes its new state on to the cell, instanced tiles are recolored from there
+	if (bObstacle)
+	{
+		Tile->SetOccupyingUnit(nullptr);
+	}
+	Tile->SetTileStatus(NewOwner, NewStatus);
+
+	if (bTilesAreInstances)
+	{
+		return;
+	}
+
+	if (!bObstacle)
+	{
+		// Back to the tile's own material
+		Tile->DrawHighlight(ETileVisual::GROUND);
+		return;
+	}
+
+	// Call the blueprint event to update the visual appearance
+	ResolveTileEvents();
+	if (ObstacleEvent)
+	{
+		Tile->ProcessEvent(ObstacleEvent, nullptr);
+	}
+	else
+	{
+		// Fallback if blueprint function doesn't exist
+		GEngine->AddOnScreenDebugMessage(-1, 3.f, FColor::Yellow,
+			TEXT("SetObstacleMaterial function not found in Blueprint"));
+	}
+}
+
+void AGrid::UpdateCellBits(const int32 Index)
+{
+	const FGridCell& Cell = Cells[Index];
+
+	ObstacleBits.Set(Index, Cell.bObstacle);
+	OccupiedBits.Set(Index, Cell.UnitSlot != INDEX_NONE);
+	WalkableBits.Set(Index, IsCellWalkable(Index));
+
+	for (int32 PlayerIndex = 0; PlayerIndex < MAX_PLAYERS; PlayerIndex++)
+	{
+		OwnerBits[PlayerIndex].Set(Index, Cell.Owner == PlayerIndex);
+	}
+}
+
+const FGridBitboard* AGrid::GetOwnerBits(const int32 PlayerIndex) const
+{
+	return (PlayerIndex >= 0 && PlayerIndex < MAX_PLAYERS) ? &OwnerBits[PlayerIndex] : nullptr;
+}
+
+const FGridDistanceField& AGrid::GetDistanceField(const int32 SourceIndex, const int32 Range, const EGridQuery Query)
+{
+	if (const FGridDistanceField* Cached = DistanceCache.Find(SourceIndex, Range, Query, BoardVersion))
+	{
+		return *Cached;
+	}
+
+	FGridDistanceField& Field = DistanceCache.Add(SourceIndex, Range, Query, BoardVersion);
+	if (Field.Reached.GetSize() != Size)
+	{
+		Field.Reached.Init(Size);
+	}
+	else
+	{
+		Field.Reached.Reset();
+	}
+
+	Field.Reached.Set(SourceIndex, true);
+	Field.Cells.Add(SourceIndex);
+	Field.Distances.Add(0);
+
+	// Movement only enters free ground, attacks go through anything
+	const FGridBitboard* Passable = (Query == EGridQuery::Movement) ? &WalkableBits : nullptr;
+
+	// Each dilation adds the ring one step further out, whole words at a time
+	for (int32 Distance = 1; Range < 0 || Distance <= Range; Distance++)
+	{
+		if (!Field.Reached.Dilate(Passable, ScratchBits))
+		{
+			break;
+		}
+
+		FrontierBits = Field.Reached;
+		FrontierBits.AndNot(ScratchBits);
+		FrontierBits.ForEachSetBit([&Field, Distance](const int32 Index)
+			{
+				Field.Cells.Add(Index);
+				Field.Distances.Add(Distance);
+			});
+	}
+	TBS_COUNTER_ADD(TBS_BFSNodes, Field.Cells.Num());
+
+#if !UE_BUILD_SHIPPING
+	// The BFS kernel must agree with the rings
+	if (CVarValidateGrid.GetValueOnGameThread() != 0)
+	{
+		const int32 NumVisited = Passable ?
+			BFS.Run(SourceIndex, Range, [this](const int32 Index) { return IsCellWalkable(Index); }) :
+			BFS.Run(SourceIndex, Range, [](const int32 Index) { return true; });
+		ensureMsgf(NumVisited == Field.Cells.Num(), TEXT("Distance field has %d cells, BFS %d"), Field.Cells.Num(), NumVisited);
+	}
+#endif
+
+	return Field;
+}
+
+void AGrid::ComputeReachableBits(const int32 StartIndex, const int32 MaxSteps, const FGridBitboard* Passable, FGridBitboard& OutBits) const
+{
+	if (OutBits.GetSize() != Size)
+	{
+		OutBits.Init(Size);
+	}
+
+	OutBits.FloodFill(StartIndex, MaxSteps, Passable, ScratchBits);
 }
 
 // Clicking on a tile returns its position
@@ -128,154 +785,156 @@ FVector2D AGrid::GetXYPositionByRelativeLocation(const FVector& Location) const
 	return FVector2D(GridX, GridY);
 }
 
-void AGrid::ValidateAllObstacles()
+int32 AGrid::GetCellIndexByRelativeLocation(const FVector& Location) const
 {
-	int32 fixedObstacles = 0;
-	int32 clearedPhantoms = 0;
+	const FVector2D Position = GetXYPositionByRelativeLocation(Location);
+	const int32 GridX = static_cast<int32>(Position.X);
+	const int32 GridY = static_cast<int32>(Position.Y);
 
-	for (ATile* Tile : TileArray)
+	return IsValidCell(GridX, GridY) ? GetCellIndex(GridX, GridY) : INDEX_NONE;
+}
+
+int32 AGrid::GetCellIndexByRay(const FVector& RayOrigin, const FVector& RayDirection) const
+{
+	// The tiles lie on the horizontal plane through the grid origin
+	const FVector BoardOrigin = GetActorLocation();
+
+	// A ray parallel to the board never meets it
+	if (FMath::IsNearlyZero(RayDirection.Z))
 	{
-		if (!Tile) continue;
+		return INDEX_NONE;
+	}
 
-		// If owner is -2, fully set up as an obstacle
-		if (Tile->GetOwner() == -2)
+	// Nor does one pointing away from it
+	const double Distance = (BoardOrigin.Z - RayOrigin.Z) / RayDirection.Z;
+	if (Distance < 0.0)
+	{
+		return INDEX_NONE;
+	}
+
+	return GetCellIndexByRelativeLocation(RayOrigin + RayDirection * Distance - BoardOrigin);
+}
+
+void AGrid::ValidateDirtyCells()
+{
+#if !UE_BUILD_SHIPPING
+	if (CVarValidateGrid.GetValueOnGameThread() == 0 || DirtyCells.GetSize() != Size)
+	{
+		return;
+	}
+
+	// The repairs below mark their cells again, they are consistent by construction
+	const FGridBitboard ChangedCells = DirtyCells;
+	DirtyCells.Reset();
+
+	int32 NumRepaired = 0;
+	ChangedCells.ForEachSetBit([this, &NumRepaired](const int32 Index)
 		{
-			// Set status to OCCUPIED
-			Tile->SetTileStatus(-2, ETileStatus::OCCUPIED);
+			// Cells without a tile actor have nothing to disagree with
+			ATile* Tile = FindTileByIndex(Index);
+			if (!Tile)
+			{
+				return;
+			}
 
-			// Clear any unit that might be wrongly assigned
-			Tile->SetOccupyingUnit(nullptr);
+			// The cell must mirror its tile
+			const FGridCell& Cell = Cells[Index];
+			if (Cell.Owner != Tile->GetOwner() || Cell.Status != Tile->GetTileStatus() || GetCellUnit(Index) != Tile->GetOccupyingUnit())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Cell %d is out of sync with its tile"), Index);
+				UpdateCellStatus(Index, Tile->GetOwner(), Tile->GetTileStatus());
+				UpdateCellUnit(Index, Tile->GetOccupyingUnit());
+				NumRepaired++;
+			}
 
-			// Update visual appearance
-			if (UFunction* Function = Tile->FindFunction(TEXT("SetObstacleMaterial")))
+			// Obstacles are occupied and hold no unit
+			if (Tile->IsObstacle() && (Tile->GetTileStatus() != ETileStatus::OCCUPIED || Tile->GetOccupyingUnit()))
 			{
-				Tile->ProcessEvent(Function, nullptr);
+				UE_LOG(LogTemp, Warning, TEXT("Obstacle cell %d is not a plain obstacle"), Index);
+				Tile->SetOccupyingUnit(nullptr);
+				Tile->SetTileStatus(OBSTACLE_OWNER, ETileStatus::OCCUPIED);
+				NumRepaired++;
 			}
 
-			fixedObstacles++;
-		}
+			// Clear any "phantom obstacles" - occupied tiles with no unit
+			else if (!Tile->IsObstacle() && Tile->GetTileStatus() == ETileStatus::OCCUPIED && !Tile->GetOccupyingUnit())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Cell %d is occupied without a unit"), Index);
+				Tile->SetTileStatus(NOT_ASSIGNED, ETileStatus::EMPTY);
+				NumRepaired++;
+			}
+		});
 
-		// Clear any "phantom obstacles" - occupied tiles with no unit
-		else if (Tile->GetTileStatus() == ETileStatus::OCCUPIED &&
-			!Tile->GetOccupyingUnit() &&
-			Tile->GetOwner() != -2)
-		{
-			// Reset to empty state
-			Tile->SetTileStatus(NOT_ASSIGNED, ETileStatus::EMPTY);
-			clearedPhantoms++;
-		}
+	if (NumRepaired > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Grid validation repaired %d of %d changed cells"), NumRepaired, ChangedCells.CountBits());
 	}
-
+#endif
 }
 
 bool AGrid::ValidateConnectivity()
 {
-	// Find the first empty tile to start our search
-	ATile* StartTile = nullptr;
-	for (ATile* Tile : TileArray)
+	TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_ValidateConnectivity);
+
+	// Find the first walkable cell to start our search
+	int32 StartIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < Cells.Num(); Index++)
 	{
-		if (Tile && Tile->GetTileStatus() == ETileStatus::EMPTY && !Tile->IsObstacle())
+		if (IsCellWalkable(Index))
 		{
-			StartTile = Tile;
+			StartIndex = Index;
 			break;
 		}
 	}
 
 	// If no empty tiles, connectivity is trivial
-	if (!StartTile)
+	if (StartIndex == INDEX_NONE)
 	{
 		return true;
 	}
 
-	// Perform a simple BFS from the start tile
-	TArray<ATile*> Queue;
-	TSet<ATile*> Visited;
-
-	Queue.Add(StartTile);
-	Visited.Add(StartTile);
-
-	while (Queue.Num() > 0)
-	{
-		ATile* CurrentTile = Queue[0];
-		Queue.RemoveAt(0);
-
-		FVector2D CurrentPos = CurrentTile->GetGridPosition();
-
-		// Check all four neighboring tiles (up, down, left, right)
-		TArray<FVector2D> Directions = {
-			FVector2D(0, 1),   // Up
-			FVector2D(0, -1),  // Down
-			FVector2D(1, 0),   // Right
-			FVector2D(-1, 0)   // Left
-		};
-
-		for (const FVector2D& Dir : Directions)
+	// Perform a BFS over the free ground from the start cell
+	const int32 VisitedCount = BFS.Run(StartIndex, -1, [this](const int32 Index)
 		{
-			FVector2D NewPos = CurrentPos + Dir;
-
-			// Skip if outside grid
-			if (NewPos.X < 0 || NewPos.X >= Size || NewPos.Y < 0 || NewPos.Y >= Size)
-				continue;
-
-			// Get the tile at the new position
-			ATile* NextTile = nullptr;
-			if (TileMap.Contains(NewPos))
-			{
-				NextTile = TileMap[NewPos];
-			}
+			return IsCellWalkable(Index);
+		});
+	TBS_COUNTER_ADD(TBS_BFSNodes, VisitedCount);
 
-			// Skip if no tile, already visited, or not empty/walkable
-			if (!NextTile || Visited.Contains(NextTile))
-				continue;
-
-			if (NextTile->GetTileStatus() != ETileStatus::EMPTY || NextTile->IsObstacle())
-				continue;
-
-			// Add to visited and queue
-			Visited.Add(NextTile);
-			Queue.Add(NextTile);
-		}
-	}
-
-	// Count total empty tiles
-	int32 TotalEmptyTiles = 0;
-	for (ATile* Tile : TileArray)
+#if !UE_BUILD_SHIPPING
+	// The bitboard flood fill must find the same area as the BFS
+	if (CVarValidateGrid.GetValueOnGameThread() != 0)
 	{
-		if (Tile && Tile->GetTileStatus() == ETileStatus::EMPTY && !Tile->IsObstacle())
-		{
-			TotalEmptyTiles++;
-		}
+		ComputeReachableBits(StartIndex, -1, &WalkableBits, FrontierBits);
+		ensureMsgf(FrontierBits.CountBits() == VisitedCount, TEXT("Flood fill reached %d cells, BFS %d"), FrontierBits.CountBits(), VisitedCount);
 	}
-
-	int32 VisitedCount = Visited.Num();
+#endif
 
 	// The grid is connected if we visited all empty tiles
-	return (VisitedCount == TotalEmptyTiles);
+	return (VisitedCount == WalkableBits.CountBits());
 }
 
 void AGrid::DiagnoseGridState()
 {
-	if (TileArray.Num() == 0)
+	if (Cells.Num() == 0)
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 10.f, FColor::Red, TEXT("ERROR: No tiles in grid"));
 		return;
 	}
 
-	int32 totalTiles = TileArray.Num();
+	int32 totalTiles = Cells.Num();
 	int32 emptyTiles = 0;
 	int32 occupiedTiles = 0;
 	int32 obstacleTiles = 0;
 	int32 inconsistentTiles = 0;
 
-	for (ATile* Tile : TileArray)
+	// Counted from the cells, an instanced board only has tile actors for the cells that needed one
+	for (int32 Index = 0; Index < Cells.Num(); Index++)
 	{
-		if (!Tile)
-			continue;
-
-		ETileStatus status = Tile->GetTileStatus();
-		int32 owner = Tile->GetOwner();
-		bool isObstacle = Tile->IsObstacle();
-		AUnit* occupyingUnit = Tile->GetOccupyingUnit();
+		const FGridCell& Cell = Cells[Index];
+		ETileStatus status = Cell.Status;
+		int32 owner = Cell.Owner;
+		bool isObstacle = Cell.bObstacle;
+		AUnit* occupyingUnit = GetCellUnit(Index);
 
 		// Check for empty tiles
 		if (status == ETileStatus::EMPTY && !isObstacle && !occupyingUnit)
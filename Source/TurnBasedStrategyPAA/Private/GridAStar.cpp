@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridAStar.h"
+
+FGridAStar::FGridAStar()
+	: Size(0)
+	, GoalIndex(INDEX_NONE)
+	, NumExpanded(0)
+	, Generation(0)
+	, HeapSize(0)
+{
+}
+
+void FGridAStar::Init(const int32 InSize)
+{
+	Size = InSize;
+	GoalIndex = INDEX_NONE;
+	NumExpanded = 0;
+	Generation = 0;
+	HeapSize = 0;
+
+	const int32 NumCells = Size * Size;
+	Nodes.SetNumUninitialized(NumCells);
+	Heap.SetNumUninitialized(NumCells);
+	Stamp.Init(0, NumCells);
+}
+
+void FGridAStar::BeginQuery(const int32 InGoalIndex)
+{
+	GoalIndex = InGoalIndex;
+	NumExpanded = 0;
+	HeapSize = 0;
+
+	// Nodes from older queries become stale, clear them only when the counter wraps
+	Generation++;
+	if (Generation == 0)
+	{
+		FMemory::Memzero(Stamp.GetData(), Stamp.Num() * sizeof(uint32));
+		Generation = 1;
+	}
+}
+
+void FGridAStar::GetPath(TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+	if (GoalIndex == INDEX_NONE || Stamp[GoalIndex] != Generation)
+	{
+		return;
+	}
+
+	// Walk back from the goal, then flip the steps in place
+	OutPath.SetNumUninitialized(GetPathLength());
+	int32 Step = OutPath.Num() - 1;
+	for (int32 Index = GoalIndex; Step >= 0; Index = Nodes[Index].ParentIndex)
+	{
+		OutPath[Step--] = Index;
+	}
+}
+
+int32 FGridAStar::PopBest()
+{
+	const int32 Best = Heap[0];
+	Nodes[Best].HeapIndex = CLOSED;
+
+	HeapSize--;
+	if (HeapSize > 0)
+	{
+		Heap[0] = Heap[HeapSize];
+		Nodes[Heap[0]].HeapIndex = 0;
+		SiftDown(0);
+	}
+
+	return Best;
+}
+
+void FGridAStar::SiftUp(int32 Position)
+{
+	const int32 Index = Heap[Position];
+
+	while (Position > 0)
+	{
+		const int32 ParentPosition = (Position - 1) / 2;
+		const int32 ParentIndex = Heap[ParentPosition];
+		if (!IsBetter(Index, ParentIndex))
+		{
+			break;
+		}
+
+		Heap[Position] = ParentIndex;
+		Nodes[ParentIndex].HeapIndex = Position;
+		Position = ParentPosition;
+	}
+
+	Heap[Position] = Index;
+	Nodes[Index].HeapIndex = Position;
+}
+
+void FGridAStar::SiftDown(int32 Position)
+{
+	const int32 Index = Heap[Position];
+
+	while (true)
+	{
+		int32 ChildPosition = Position * 2 + 1;
+		if (ChildPosition >= HeapSize)
+		{
+			break;
+		}
+
+		// Pick the better of the two children
+		if (ChildPosition + 1 < HeapSize && IsBetter(Heap[ChildPosition + 1], Heap[ChildPosition]))
+		{
+			ChildPosition++;
+		}
+
+		const int32 ChildIndex = Heap[ChildPosition];
+		if (!IsBetter(ChildIndex, Index))
+		{
+			break;
+		}
+
+		Heap[Position] = ChildIndex;
+		Nodes[ChildIndex].HeapIndex = Position;
+		Position = ChildPosition;
+	}
+
+	Heap[Position] = Index;
+	Nodes[Index].HeapIndex = Position;
+}
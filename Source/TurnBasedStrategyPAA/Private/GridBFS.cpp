@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridBFS.h"
+
+FGridBFS::FGridBFS()
+	: Size(0)
+	, Generation(0)
+	, Head(0)
+	, Tail(0)
+{
+}
+
+void FGridBFS::Init(const int32 InSize)
+{
+	Size = InSize;
+	Generation = 0;
+	Head = 0;
+	Tail = 0;
+
+	const int32 NumCells = Size * Size;
+	Queue.SetNumUninitialized(NumCells);
+	Distance.SetNumUninitialized(NumCells);
+	Parent.SetNumUninitialized(NumCells);
+	Stamp.Init(0, NumCells);
+}
+
+void FGridBFS::BeginQuery()
+{
+	Head = 0;
+	Tail = 0;
+
+	// Stamps from older queries become stale, clear them only when the counter wraps
+	Generation++;
+	if (Generation == 0)
+	{
+		FMemory::Memzero(Stamp.GetData(), Stamp.Num() * sizeof(uint32));
+		Generation = 1;
+	}
+}
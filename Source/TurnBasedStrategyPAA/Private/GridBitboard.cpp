@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridBitboard.h"
+
+FGridBitboard::FGridBitboard()
+	: Size(0)
+	, WordsPerRow(0)
+	, TailMask(0)
+{
+}
+
+void FGridBitboard::Init(const int32 InSize)
+{
+	Size = InSize;
+	WordsPerRow = (Size + 63) / 64;
+	Words.Init(0, WordsPerRow * Size);
+
+	// Bits past the last column must always stay clear
+	const int32 TailBits = Size - (WordsPerRow - 1) * 64;
+	TailMask = (TailBits >= 64) ? ~0ull : ((1ull << TailBits) - 1);
+}
+
+void FGridBitboard::Reset()
+{
+	FMemory::Memzero(Words.GetData(), Words.Num() * sizeof(uint64));
+}
+
+void FGridBitboard::SetAll()
+{
+	for (int32 Row = 0; Row < Size; Row++)
+	{
+		for (int32 WordInRow = 0; WordInRow < WordsPerRow; WordInRow++)
+		{
+			Words[Row * WordsPerRow + WordInRow] = (WordInRow == WordsPerRow - 1) ? TailMask : ~0ull;
+		}
+	}
+}
+
+bool FGridBitboard::Get(const int32 Index) const
+{
+	const int32 X = Index % Size;
+	const int32 Y = Index / Size;
+	return (Words[Y * WordsPerRow + X / 64] >> (X % 64)) & 1ull;
+}
+
+void FGridBitboard::Set(const int32 Index, const bool bValue)
+{
+	const int32 X = Index % Size;
+	const int32 Y = Index / Size;
+	const uint64 Bit = 1ull << (X % 64);
+	uint64& Word = Words[Y * WordsPerRow + X / 64];
+
+	Word = bValue ? (Word | Bit) : (Word & ~Bit);
+}
+
+int32 FGridBitboard::CountBits() const
+{
+	int32 Count = 0;
+	for (const uint64 Word : Words)
+	{
+		Count += static_cast<int32>(FMath::CountBits(Word));
+	}
+	return Count;
+}
+
+bool FGridBitboard::IsEmpty() const
+{
+	for (const uint64 Word : Words)
+	{
+		if (Word)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FGridBitboard& FGridBitboard::operator&=(const FGridBitboard& Other)
+{
+	check(Other.Words.Num() == Words.Num());
+	for (int32 i = 0; i < Words.Num(); i++)
+	{
+		Words[i] &= Other.Words[i];
+	}
+	return *this;
+}
+
+FGridBitboard& FGridBitboard::operator|=(const FGridBitboard& Other)
+{
+	check(Other.Words.Num() == Words.Num());
+	for (int32 i = 0; i < Words.Num(); i++)
+	{
+		Words[i] |= Other.Words[i];
+	}
+	return *this;
+}
+
+FGridBitboard& FGridBitboard::operator^=(const FGridBitboard& Other)
+{
+	check(Other.Words.Num() == Words.Num());
+	for (int32 i = 0; i < Words.Num(); i++)
+	{
+		Words[i] ^= Other.Words[i];
+	}
+	return *this;
+}
+
+void FGridBitboard::AndNot(const FGridBitboard& Other)
+{
+	check(Other.Words.Num() == Words.Num());
+	for (int32 i = 0; i < Words.Num(); i++)
+	{
+		Words[i] &= ~Other.Words[i];
+	}
+}
+
+bool FGridBitboard::Dilate(const FGridBitboard* Passable, FGridBitboard& Scratch)
+{
+	if (Scratch.Words.Num() != Words.Num())
+	{
+		Scratch.Init(Size);
+	}
+
+	bool bChanged = false;
+
+	for (int32 Row = 0; Row < Size; Row++)
+	{
+		const int32 RowStart = Row * WordsPerRow;
+
+		for (int32 WordInRow = 0; WordInRow < WordsPerRow; WordInRow++)
+		{
+			const int32 i = RowStart + WordInRow;
+			const uint64 Current = Words[i];
+
+			// Right and left neighbours inside the word
+			uint64 Grown = Current | (Current << 1) | (Current >> 1);
+
+			// Neighbours crossing a word boundary of the same row
+			if (WordInRow > 0)
+			{
+				Grown |= Words[i - 1] >> 63;
+			}
+			if (WordInRow < WordsPerRow - 1)
+			{
+				Grown |= Words[i + 1] << 63;
+			}
+			else
+			{
+				Grown &= TailMask;
+			}
+
+			// Neighbours in the rows below and above
+			if (Row > 0)
+			{
+				Grown |= Words[i - WordsPerRow];
+			}
+			if (Row < Size - 1)
+			{
+				Grown |= Words[i + WordsPerRow];
+			}
+
+			// Newly reached cells must be passable, the ones already reached are kept
+			if (Passable)
+			{
+				Grown = (Grown & Passable->Words[i]) | Current;
+			}
+
+			bChanged |= (Grown != Current);
+			Scratch.Words[i] = Grown;
+		}
+	}
+
+	// The scratch now holds the result, swap the buffers without copying
+	Swap(Words, Scratch.Words);
+	return bChanged;
+}
+
+void FGridBitboard::FloodFill(const int32 StartIndex, const int32 MaxSteps, const FGridBitboard* Passable, FGridBitboard& Scratch)
+{
+	Reset();
+	Set(StartIndex, true);
+
+	for (int32 Step = 0; MaxSteps < 0 || Step < MaxSteps; Step++)
+	{
+		// Stop as soon as the frontier can't advance any more
+		if (!Dilate(Passable, Scratch))
+		{
+			break;
+		}
+	}
+}
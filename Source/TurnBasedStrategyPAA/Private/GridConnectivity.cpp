@@ -0,0 +1,307 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridConnectivity.h"
+
+// How far the local searches look before falling back to the articulation points
+static constexpr int32 LOCAL_SEARCH_RADII[] = { 6, 24 };
+
+// (x, y) offsets of the 8 cells around a cell, walking the ring clockwise from the top
+// even slots are the orthogonal neighbours, odd slots are the diagonal corners between them
+static constexpr int32 RingX[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static constexpr int32 RingY[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+
+FGridConnectivity::FGridConnectivity()
+	: Size(0)
+	, FreeCount(0)
+	, bAllBlocksDirty(true)
+{
+}
+
+void FGridConnectivity::Init(const int32 InSize)
+{
+	Size = InSize;
+	FreeCount = Size * Size;
+
+	const int32 NumCells = Size * Size;
+	FreeCells.Init(true, NumCells);
+	LocalBFS.Init(Size);
+
+	BlockIds.SetNumUninitialized(NumCells);
+	DirtyBlocks.Reset(NumCells);
+	bAllBlocksDirty = true;
+
+	Discovery.SetNumUninitialized(NumCells);
+	Low.SetNumUninitialized(NumCells);
+	StackCells.SetNumUninitialized(NumCells);
+	StackDirections.SetNumUninitialized(NumCells);
+	BlockStack.SetNumUninitialized(NumCells);
+}
+
+bool FGridConnectivity::IsFreeAt(const int32 X, const int32 Y) const
+{
+	// Outside of the grid counts as blocked
+	return X >= 0 && X < Size && Y >= 0 && Y < Size && FreeCells[Y * Size + X];
+}
+
+void FGridConnectivity::Block(const int32 Index)
+{
+	if (!FreeCells[Index])
+	{
+		return;
+	}
+
+	FreeCells[Index] = false;
+	FreeCount--;
+
+	// Removing a cell can turn the other cells of its block into cut cells
+	if (!bAllBlocksDirty)
+	{
+		const int32 BlockId = BlockIds[Index];
+		if (BlockId >= 0)
+		{
+			DirtyBlocks[BlockId] = true;
+		}
+		else
+		{
+			bAllBlocksDirty = true;
+		}
+	}
+}
+
+EGridBlockCheck FGridConnectivity::CheckBlock(const int32 Index)
+{
+	if (!FreeCells[Index])
+	{
+		return EGridBlockCheck::Disconnects;
+	}
+
+	// A single group of neighbours means every path through this cell can go around it
+	int32 GroupCells[4];
+	const int32 NumGroups = GetRingGroups(Index, GroupCells);
+	if (NumGroups <= 1)
+	{
+		return EGridBlockCheck::Safe;
+	}
+
+	// Most of the remaining cases are settled by looking just around the cell
+	for (const int32 Radius : LOCAL_SEARCH_RADII)
+	{
+		const int32 LocalResult = CheckGroupsLocally(Index, GroupCells, NumGroups, Radius);
+		if (LocalResult != INDEX_NONE)
+		{
+			return (LocalResult == 1) ? EGridBlockCheck::Safe : EGridBlockCheck::Disconnects;
+		}
+	}
+
+	// Otherwise ask the block structure, if the block of this cell didn't change since the last rebuild
+	if (bAllBlocksDirty || (BlockIds[Index] >= 0 && DirtyBlocks[BlockIds[Index]]))
+	{
+		return EGridBlockCheck::Unknown;
+	}
+
+	// A cell is a cut cell if it is shared by several blocks
+	// cut cells from an older rebuild are refused too, at worst we lose one candidate
+	return (BlockIds[Index] == SHARED_BLOCK) ? EGridBlockCheck::Disconnects : EGridBlockCheck::Safe;
+}
+
+bool FGridConnectivity::CanBlock(const int32 Index)
+{
+	EGridBlockCheck Result = CheckBlock(Index);
+	if (Result == EGridBlockCheck::Unknown)
+	{
+		RebuildBlocks();
+		Result = (BlockIds[Index] == SHARED_BLOCK) ? EGridBlockCheck::Disconnects : EGridBlockCheck::Safe;
+	}
+	return Result == EGridBlockCheck::Safe;
+}
+
+int32 FGridConnectivity::GetRingGroups(const int32 Index, int32 OutGroupCells[4]) const
+{
+	const int32 X = Index % Size;
+	const int32 Y = Index / Size;
+
+	bool bRingFree[8];
+	for (int32 Slot = 0; Slot < 8; Slot++)
+	{
+		bRingFree[Slot] = IsFreeAt(X + RingX[Slot], Y + RingY[Slot]);
+	}
+
+	// Two consecutive orthogonal neighbours are joined if the corner between them is free too
+	int32 NumNeighbours = 0;
+	int32 NumLinks = 0;
+	int32 NumGroups = 0;
+
+	for (int32 Slot = 0; Slot < 8; Slot += 2)
+	{
+		if (!bRingFree[Slot])
+		{
+			continue;
+		}
+
+		NumNeighbours++;
+
+		const int32 NextSlot = (Slot + 2) % 8;
+		const int32 PrevSlot = (Slot + 6) % 8;
+		if (bRingFree[Slot + 1] && bRingFree[NextSlot])
+		{
+			NumLinks++;
+		}
+
+		// First cell of a group: not joined to the previous orthogonal neighbour
+		if (!(bRingFree[PrevSlot] && bRingFree[(Slot + 7) % 8]))
+		{
+			OutGroupCells[NumGroups++] = (Y + RingY[Slot]) * Size + (X + RingX[Slot]);
+		}
+	}
+
+	// All four neighbours joined in a loop around the cell
+	if (NumNeighbours == 4 && NumLinks == 4)
+	{
+		OutGroupCells[0] = (Y + RingY[0]) * Size + (X + RingX[0]);
+		return 1;
+	}
+
+	check(NumGroups == NumNeighbours - NumLinks);
+	return NumGroups;
+}
+
+int32 FGridConnectivity::CheckGroupsLocally(const int32 Index, const int32* GroupCells, const int32 NumGroups, const int32 Radius)
+{
+	// Grow from every group in turn, a small pocket is usually closed off quickly from its own side
+	for (int32 Group = 0; Group < NumGroups; Group++)
+	{
+		LocalBFS.Run(GroupCells[Group], Radius, [this, Index](const int32 Cell)
+			{
+				return Cell != Index && FreeCells[Cell];
+			});
+
+		bool bAllReached = true;
+		for (int32 Other = 0; Other < NumGroups; Other++)
+		{
+			if (!LocalBFS.IsVisited(GroupCells[Other]))
+			{
+				bAllReached = false;
+				break;
+			}
+		}
+
+		if (bAllReached)
+		{
+			return 1;
+		}
+
+		// The search ran out of cells before reaching its radius: this group is closed off
+		const TArrayView<const int32> Visited = LocalBFS.GetVisitedCells();
+		if (LocalBFS.GetDistance(Visited[Visited.Num() - 1]) < Radius)
+		{
+			return 0;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void FGridConnectivity::RebuildBlocks()
+{
+	const int32 NumCells = Size * Size;
+	for (int32 Index = 0; Index < NumCells; Index++)
+	{
+		Discovery[Index] = INDEX_NONE;
+		BlockIds[Index] = INDEX_NONE;
+	}
+	DirtyBlocks.Reset();
+
+	// Adds a cell to a block, a cell added to a second block is a cut cell
+	auto AddToBlock = [this](const int32 Cell, const int32 BlockId)
+		{
+			BlockIds[Cell] = (BlockIds[Cell] == INDEX_NONE || BlockIds[Cell] == BlockId) ? BlockId : SHARED_BLOCK;
+		};
+
+	int32 Time = 0;
+
+	for (int32 Root = 0; Root < NumCells; Root++)
+	{
+		if (!FreeCells[Root] || Discovery[Root] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		// Depth first search, every stack entry keeps the next direction to try
+		int32 StackSize = 0;
+		int32 BlockStackSize = 0;
+
+		Discovery[Root] = Low[Root] = Time++;
+		StackCells[StackSize] = Root;
+		StackDirections[StackSize] = 0;
+		StackSize++;
+
+		while (StackSize > 0)
+		{
+			const int32 Top = StackSize - 1;
+			const int32 Cell = StackCells[Top];
+			const int32 ParentCell = (Top > 0) ? StackCells[Top - 1] : INDEX_NONE;
+
+			if (StackDirections[Top] < FGridDirections::Num)
+			{
+				const int32 Direction = StackDirections[Top]++;
+				const int32 NextX = Cell % Size + FGridDirections::X[Direction];
+				const int32 NextY = Cell / Size + FGridDirections::Y[Direction];
+
+				if (!IsFreeAt(NextX, NextY))
+				{
+					continue;
+				}
+
+				const int32 Next = NextY * Size + NextX;
+				if (Discovery[Next] == INDEX_NONE)
+				{
+					// Tree edge, go deeper
+					Discovery[Next] = Low[Next] = Time++;
+					StackCells[StackSize] = Next;
+					StackDirections[StackSize] = 0;
+					StackSize++;
+					BlockStack[BlockStackSize++] = Next;
+				}
+				else if (Next != ParentCell)
+				{
+					// Back edge
+					Low[Cell] = FMath::Min(Low[Cell], Discovery[Next]);
+				}
+				continue;
+			}
+
+			// All the neighbours are done, report to the parent
+			StackSize--;
+			if (ParentCell == INDEX_NONE)
+			{
+				continue;
+			}
+
+			Low[ParentCell] = FMath::Min(Low[ParentCell], Low[Cell]);
+
+			// The subtree of Cell can't reach above its parent: they close a block
+			if (Low[Cell] >= Discovery[ParentCell])
+			{
+				const int32 BlockId = DirtyBlocks.Add(false);
+
+				int32 Member;
+				do
+				{
+					Member = BlockStack[--BlockStackSize];
+					AddToBlock(Member, BlockId);
+				} while (Member != Cell);
+
+				AddToBlock(ParentCell, BlockId);
+			}
+		}
+
+		// A lone free cell is a block by itself
+		if (BlockIds[Root] == INDEX_NONE)
+		{
+			BlockIds[Root] = DirtyBlocks.Add(false);
+		}
+	}
+
+	bAllBlocksDirty = false;
+}
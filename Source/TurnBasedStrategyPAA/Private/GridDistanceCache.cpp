@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridDistanceCache.h"
+
+FGridDistanceCache::FGridDistanceCache()
+	: NextEntry(0)
+{
+}
+
+const FGridDistanceField* FGridDistanceCache::Find(const int32 SourceIndex, const int32 Range, const EGridQuery Query, const uint32 Version) const
+{
+	for (const FGridDistanceField& Entry : Entries)
+	{
+		if (Entry.Matches(SourceIndex, Range, Query, Version))
+		{
+			return &Entry;
+		}
+	}
+	return nullptr;
+}
+
+FGridDistanceField& FGridDistanceCache::Add(const int32 SourceIndex, const int32 Range, const EGridQuery Query, const uint32 Version)
+{
+	FGridDistanceField& Entry = Entries[NextEntry];
+	NextEntry = (NextEntry + 1) % NUM_ENTRIES;
+
+	Entry.SourceIndex = SourceIndex;
+	Entry.Range = Range;
+	Entry.Query = Query;
+	Entry.Version = Version;
+	Entry.Cells.Reset();
+	Entry.Distances.Reset();
+
+	return Entry;
+}
+
+void FGridDistanceCache::Reset()
+{
+	for (FGridDistanceField& Entry : Entries)
+	{
+		Entry.SourceIndex = INDEX_NONE;
+		Entry.Version = 0;
+	}
+	NextEntry = 0;
+}
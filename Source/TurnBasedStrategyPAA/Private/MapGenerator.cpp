@@ -0,0 +1,279 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MapGenerator.h"
+#include "GridConnectivity.h"
+#include "Async/ParallelFor.h"
+
+void FMapGenerator::Generate(const int32 Seed, const int32 Size, const float ObstaclePercentage, FMapLayout& OutLayout)
+{
+	FTBSRandom Stream(static_cast<uint32>(Seed));
+
+	OutLayout.Seed = Seed;
+	OutLayout.ObstaclePercentage = ObstaclePercentage;
+	OutLayout.NumObstacles = 0;
+	OutLayout.Obstacles.Init(Size);
+
+	if (Size <= 0 || ObstaclePercentage <= 0.0f)
+	{
+		return;
+	}
+
+	// Calculate target obstacles based on percentage, capped to the maximum
+	const int32 NumCells = Size * Size;
+	int32 TargetObstacles = FMath::RoundToInt((ObstaclePercentage / 100.0f) * NumCells);
+	TargetObstacles = FMath::Min(TargetObstacles, FMath::RoundToInt(MAX_OBSTACLE_RATIO * NumCells));
+
+	// Free space of the board, answers whether an obstacle would split it
+	FGridConnectivity Connectivity;
+	Connectivity.Init(Size);
+
+	auto PlaceObstacle = [&OutLayout, &Connectivity](const int32 Index)
+		{
+			Connectivity.Block(Index);
+			OutLayout.Obstacles.Set(Index, true);
+			OutLayout.NumObstacles++;
+		};
+
+	auto GetNeighbourIndex = [Size](const int32 Index, const int32 Direction)
+		{
+			const int32 X = Index % Size + FGridDirections::X[Direction];
+			const int32 Y = Index / Size + FGridDirections::Y[Direction];
+			return (X >= 0 && X < Size && Y >= 0 && Y < Size) ? Y * Size + X : INDEX_NONE;
+		};
+
+	// Create a grid pattern with spacing based on percentage
+	float StepSize = FMath::Sqrt(100.0f / ObstaclePercentage);
+	StepSize = FMath::Max(StepSize, 1.5f);
+
+	TArray<int32> PatternPositions;
+	for (float x = 0.0f; x < Size - 1; x += StepSize)
+	{
+		for (float y = 0.0f; y < Size - 1; y += StepSize)
+		{
+			// Add some randomness to avoid perfect grid patterns
+			const float OffsetX = Stream.FRandRange(-0.3f, 0.3f) * StepSize;
+			const float OffsetY = Stream.FRandRange(-0.3f, 0.3f) * StepSize;
+
+			const int32 GridX = FMath::RoundToInt(x + OffsetX);
+			const int32 GridY = FMath::RoundToInt(y + OffsetY);
+
+			if (GridX >= 0 && GridX < Size && GridY >= 0 && GridY < Size)
+			{
+				PatternPositions.Add(GridY * Size + GridX);
+			}
+		}
+	}
+
+	// Shuffle positions for more randomness
+	for (int32 i = PatternPositions.Num() - 1; i > 0; i--)
+	{
+		const int32 SwapIndex = Stream.RandRange(0, i);
+		if (i != SwapIndex)
+		{
+			PatternPositions.Swap(i, SwapIndex);
+		}
+	}
+
+	// Try the patterned positions
+	for (const int32 Index : PatternPositions)
+	{
+		if (OutLayout.NumObstacles >= TargetObstacles)
+		{
+			break;
+		}
+
+		// Don't leave an adjacent free cell with a single way out
+		bool bWouldBlockAdjacent = false;
+		for (int32 Direction = 0; Direction < FGridDirections::Num && !bWouldBlockAdjacent; Direction++)
+		{
+			const int32 AdjIndex = GetNeighbourIndex(Index, Direction);
+			if (AdjIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			int32 BlockedSides = 0;
+			for (int32 CheckDirection = 0; CheckDirection < FGridDirections::Num; CheckDirection++)
+			{
+				const int32 CheckIndex = GetNeighbourIndex(AdjIndex, CheckDirection);
+				if (CheckIndex != Index && (CheckIndex == INDEX_NONE || !Connectivity.IsFree(CheckIndex)))
+				{
+					BlockedSides++;
+				}
+			}
+
+			bWouldBlockAdjacent = (BlockedSides >= 2);
+		}
+
+		// Pattern cells are sparse, the cheap check is enough to keep the free space connected
+		if (!bWouldBlockAdjacent && Connectivity.CheckBlock(Index) == EGridBlockCheck::Safe)
+		{
+			PlaceObstacle(Index);
+		}
+	}
+
+	// If we didn't reach the target, try randomized positions
+	if (OutLayout.NumObstacles < TargetObstacles)
+	{
+		TArray<int32> RandomPositions;
+		RandomPositions.Reserve(Connectivity.GetFreeCount());
+		for (int32 Index = 0; Index < NumCells; Index++)
+		{
+			if (Connectivity.IsFree(Index))
+			{
+				RandomPositions.Add(Index);
+			}
+		}
+
+		for (int32 i = RandomPositions.Num() - 1; i > 0; i--)
+		{
+			const int32 SwapIndex = Stream.RandRange(0, i);
+			if (i != SwapIndex)
+			{
+				RandomPositions.Swap(i, SwapIndex);
+			}
+		}
+
+		// Cells that need a full rebuild of the block structure to be checked, tried last
+		TArray<int32> DeferredPositions;
+
+		for (const int32 Index : RandomPositions)
+		{
+			if (OutLayout.NumObstacles >= TargetObstacles)
+			{
+				break;
+			}
+
+			const EGridBlockCheck Check = Connectivity.CheckBlock(Index);
+			if (Check == EGridBlockCheck::Safe)
+			{
+				PlaceObstacle(Index);
+			}
+			else if (Check == EGridBlockCheck::Unknown)
+			{
+				DeferredPositions.Add(Index);
+			}
+		}
+
+		// Only on dense maps: settle the remaining cells with the exact check
+		for (const int32 Index : DeferredPositions)
+		{
+			if (OutLayout.NumObstacles >= TargetObstacles)
+			{
+				break;
+			}
+
+			if (Connectivity.CanBlock(Index))
+			{
+				PlaceObstacle(Index);
+			}
+		}
+	}
+}
+
+void FMapGenerator::GenerateBatch(const TArrayView<const int32> Seeds, const int32 Size, const float ObstaclePercentage, TArray<FMapLayout>& OutLayouts)
+{
+	OutLayouts.SetNum(Seeds.Num());
+
+	// Every map only depends on its own seed, so they can be built side by side
+	ParallelFor(Seeds.Num(), [&](const int32 MapIndex)
+		{
+			Generate(Seeds[MapIndex], Size, ObstaclePercentage, OutLayouts[MapIndex]);
+		});
+}
+
+void FMapPool::Configure(const int32 InSize, const float InObstaclePercentage, const int32 InBaseSeed, const int32 InPoolSize)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Size = InSize;
+	ObstaclePercentage = InObstaclePercentage;
+	PoolSize = FMath::Max(InPoolSize, 0);
+	NextSeed = InBaseSeed;
+	Version++;
+	ReadyMaps.Reset();
+}
+
+bool FMapPool::Matches(const int32 InSize, const float InObstaclePercentage) const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Size == InSize && ObstaclePercentage == InObstaclePercentage;
+}
+
+void FMapPool::Refill()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// One refill at a time keeps the maps in seed order
+	if (!RefillTask.IsCompleted() || ReadyMaps.Num() >= PoolSize)
+	{
+		return;
+	}
+
+	TArray<int32> Seeds;
+	for (int32 i = ReadyMaps.Num(); i < PoolSize; i++)
+	{
+		Seeds.Add(NextSeed++);
+	}
+
+	// The task keeps the pool alive until it's done
+	TSharedRef<FMapPool, ESPMode::ThreadSafe> Pool = AsShared();
+	RefillTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Pool, Seeds = MoveTemp(Seeds), RefillVersion = Version, RefillSize = Size, RefillPercentage = ObstaclePercentage]()
+		{
+			TArray<FMapLayout> Layouts;
+			FMapGenerator::GenerateBatch(Seeds, RefillSize, RefillPercentage, Layouts);
+
+			FScopeLock PoolLock(&Pool->Lock);
+			if (Pool->Version == RefillVersion)
+			{
+				Pool->ReadyMaps.Append(MoveTemp(Layouts));
+			}
+		});
+}
+
+void FMapPool::Flush()
+{
+	UE::Tasks::FTask Task;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Task = RefillTask;
+	}
+	Task.Wait();
+}
+
+void FMapPool::Pop(FMapLayout& OutLayout)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (ReadyMaps.Num() > 0)
+		{
+			OutLayout = MoveTemp(ReadyMaps[0]);
+			ReadyMaps.RemoveAt(0);
+			return;
+		}
+	}
+
+	// The maps being generated come first in the sequence, wait for them
+	Flush();
+
+	int32 Seed;
+	int32 PopSize;
+	float PopPercentage;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (ReadyMaps.Num() > 0)
+		{
+			OutLayout = MoveTemp(ReadyMaps[0]);
+			ReadyMaps.RemoveAt(0);
+			return;
+		}
+
+		Seed = NextSeed++;
+		PopSize = Size;
+		PopPercentage = ObstaclePercentage;
+	}
+
+	FMapGenerator::Generate(Seed, PopSize, PopPercentage, OutLayout);
+}
@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoveHistoryEntryWidget.h"
+#include "Components/TextBlock.h"
+#include "MoveHistoryWidget.h"
+#include "TBS_GameInstance.h"
+
+void UMoveHistoryEntryWidget::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+    IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+    UMoveHistoryItem* Item = Cast<UMoveHistoryItem>(ListItemObject);
+    UTBS_GameInstance* GameInstance = GetGameInstance<UTBS_GameInstance>();
+    if (!Item || !GameInstance || !LineText)
+    {
+        return;
+    }
+
+    LineText->SetText(FText::FromString(GameInstance->GetMoveHistoryLine(Item->LineIndex)));
+}
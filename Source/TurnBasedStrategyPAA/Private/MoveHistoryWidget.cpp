@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MoveHistoryWidget.h"
+#include "Components/ListView.h"
+#include "TBS_GameInstance.h"
+
+void UMoveHistoryWidget::NativeConstruct()
+{
+    Super::NativeConstruct();
+
+    UTBS_GameInstance* GameInstance = GetGameInstance<UTBS_GameInstance>();
+    if (!GameInstance || !HistoryList)
+    {
+        return;
+    }
+
+    GameInstance->OnMoveHistoryAppended.AddUniqueDynamic(this, &UMoveHistoryWidget::OnLinesAppended);
+    GameInstance->OnMoveHistoryCleared.AddUniqueDynamic(this, &UMoveHistoryWidget::OnHistoryCleared);
+
+    // Catch up with the lines logged before the widget was created
+    OnHistoryCleared();
+    OnLinesAppended(0, GameInstance->GetNumMoveHistoryLines());
+}
+
+void UMoveHistoryWidget::NativeDestruct()
+{
+    if (UTBS_GameInstance* GameInstance = GetGameInstance<UTBS_GameInstance>())
+    {
+        GameInstance->OnMoveHistoryAppended.RemoveDynamic(this, &UMoveHistoryWidget::OnLinesAppended);
+        GameInstance->OnMoveHistoryCleared.RemoveDynamic(this, &UMoveHistoryWidget::OnHistoryCleared);
+    }
+
+    Super::NativeDestruct();
+}
+
+void UMoveHistoryWidget::OnLinesAppended(int32 FirstLine, int32 NumLines)
+{
+    if (!HistoryList || NumLines <= 0)
+    {
+        return;
+    }
+
+    // Lines that would leave the list right away are skipped
+    const int32 EndLine = FirstLine + NumLines;
+    const int32 StartLine = (MaxLines > 0) ? FMath::Max(FirstLine, EndLine - MaxLines) : FirstLine;
+
+    bool bRecycled = false;
+    for (int32 Line = StartLine; Line < EndLine; Line++)
+    {
+        UMoveHistoryItem* Item = AcquireItem(bRecycled);
+        Item->LineIndex = Line;
+        HistoryList->AddItem(Item);
+    }
+
+    // An entry may still show the old line of a recycled item, only the visible entries are rebuilt
+    if (bRecycled)
+    {
+        HistoryList->RegenerateAllEntries();
+    }
+
+    if (bFollowNewLines)
+    {
+        HistoryList->ScrollIndexIntoView(HistoryList->GetNumItems() - 1);
+    }
+}
+
+void UMoveHistoryWidget::OnHistoryCleared()
+{
+    if (HistoryList)
+    {
+        HistoryList->ClearListItems();
+    }
+
+    // The items stay in the pool for the next round
+    NumPooledItemsUsed = 0;
+}
+
+UMoveHistoryItem* UMoveHistoryWidget::AcquireItem(bool& bOutRecycled)
+{
+    if (MaxLines > 0 && HistoryList->GetNumItems() >= MaxLines)
+    {
+        UMoveHistoryItem* Oldest = Cast<UMoveHistoryItem>(HistoryList->GetItemAt(0));
+        if (Oldest)
+        {
+            HistoryList->RemoveItem(Oldest);
+            bOutRecycled = true;
+            return Oldest;
+        }
+    }
+
+    if (NumPooledItemsUsed < ItemPool.Num())
+    {
+        return ItemPool[NumPooledItemsUsed++];
+    }
+
+    UMoveHistoryItem* Item = NewObject<UMoveHistoryItem>(this);
+    ItemPool.Add(Item);
+    NumPooledItemsUsed++;
+    return Item;
+}
@@ -3,19 +3,20 @@
 
 #include "Sniper.h"
 #include "Brawler.h"
+#include "TBSCombatTables.h"
 
 ASniper::ASniper()
 {
     // Sniper specific stats
     UnitType = EUnitType::SNIPER;
     UnitName = "Sniper";
-    MovementRange = 3;
+    MovementRange = FTBSCombatTables::SNIPER_MOVEMENT_RANGE;
     AttackType = EAttackType::RANGE;
-    AttackRange = 10;
-    MinDamage = 4;
-    MaxDamage = 8;
-    Health = 20;
-    MaxHealth = 20;
+    AttackRange = FTBSCombatTables::SNIPER_ATTACK_RANGE;
+    MinDamage = FTBSCombatTables::SNIPER_MIN_DAMAGE;
+    MaxDamage = FTBSCombatTables::SNIPER_MAX_DAMAGE;
+    Health = FTBSCombatTables::SNIPER_MAX_HEALTH;
+    MaxHealth = FTBSCombatTables::SNIPER_MAX_HEALTH;
 
 }
 
@@ -26,12 +27,13 @@ int32 ASniper::Attack(AUnit* TargetUnit)
         return 0;
 
     // Checks if the target is within attack range
-    TArray<ATile*> ValidAttackTiles = GetAttackTiles();
-    if (!ValidAttackTiles.Contains(TargetUnit->GetCurrentTile()))
+    if (!CanAttack(TargetUnit))
         return 0;
 
+    LastCounterDamage = 0;
+
     // Calculates damage (random between min and max)
-    int32 Damage = FMath::RandRange(MinDamage, MaxDamage);
+    int32 Damage = RollDamage(MinDamage, MaxDamage);
 
     // Applies damage to target
     TargetUnit->ReceiveDamage(Damage);
@@ -62,8 +64,9 @@ int32 ASniper::Attack(AUnit* TargetUnit)
     // Applies counterattack damage if conditions are met
     if (bShouldReceiveDamage && !IsDead())
     {
-        int32 SelfDamage = FMath::RandRange(1, 3);
+        int32 SelfDamage = RollDamage(FTBSCombatTables::COUNTER_MIN_DAMAGE, FTBSCombatTables::COUNTER_MAX_DAMAGE);
         ReceiveDamage(SelfDamage);
+        LastCounterDamage = SelfDamage;
     }
 
     bHasAttacked = true;
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSActionLog.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// Start of every log file, "TBSL"
+static constexpr uint32 ACTION_LOG_MAGIC = 0x4C534254;
+
+// Bumped whenever the file layout changes
+static constexpr uint32 ACTION_LOG_VERSION = 1;
+
+FArchive& operator<<(FArchive& Ar, FTBSLogRecord& Record)
+{
+	Ar << Record.Action;
+	Ar << Record.Player;
+	Ar << Record.Unit;
+	Ar << Record.Damage;
+	Ar << Record.CounterDamage;
+	Ar << Record.FromCell;
+	Ar << Record.ToCell;
+	return Ar;
+}
+
+FTBSActionLog::FTBSActionLog()
+{
+	Reset();
+}
+
+void FTBSActionLog::Reset()
+{
+	MatchSeed = 0;
+	MapSeed = 0;
+	GridSize = 0;
+	ObstaclePercentage = 0.0f;
+	StartingPlayer = 0;
+	Records.Reset();
+	TurnStarts.Reset();
+}
+
+void FTBSActionLog::BeginRound(const int32 InMatchSeed, const int32 InMapSeed, const int32 InGridSize, const float InObstaclePercentage)
+{
+	MatchSeed = InMatchSeed;
+	MapSeed = InMapSeed;
+	GridSize = InGridSize;
+	ObstaclePercentage = InObstaclePercentage;
+}
+
+void FTBSActionLog::SetStartingPlayer(const int32 Player)
+{
+	StartingPlayer = Player;
+}
+
+void FTBSActionLog::BeginTurn()
+{
+	TurnStarts.Add(Records.Num());
+}
+
+void FTBSActionLog::Add(const FTBSLogRecord& Record)
+{
+	Records.Add(Record);
+}
+
+int32 FTBSActionLog::GetCell(const FVector2D& Position) const
+{
+	return static_cast<int32>(Position.Y) * GridSize + static_cast<int32>(Position.X);
+}
+
+FString FTBSActionLog::FormatCell(const int32 Cell) const
+{
+	const int32 Size = FMath::Max(GridSize, 1);
+	const TCHAR Letter = TEXT('A') + Cell / Size;
+	return FString::Printf(TEXT("%c%d"), Letter, Cell % Size + 1);
+}
+
+FString FTBSActionLog::FormatRecord(const int32 Index) const
+{
+	const FTBSLogRecord& Record = Records[Index];
+	const TCHAR* Player = (Record.Player == 0) ? TEXT("HP") : TEXT("AI");
+	const TCHAR* Unit = (Record.Unit == EUnitType::BRAWLER) ? TEXT("B") : TEXT("S");
+
+	switch (Record.Action)
+	{
+	case ETBSLogAction::Place:
+		return FString::Printf(TEXT("%s: %s Place at %s"), Player, Unit, *FormatCell(Record.ToCell));
+
+	case ETBSLogAction::Move:
+		return FString::Printf(TEXT("%s: %s %s -> %s"), Player, Unit, *FormatCell(Record.FromCell), *FormatCell(Record.ToCell));
+
+	case ETBSLogAction::Attack:
+		return FString::Printf(TEXT("%s: %s %s %d"), Player, Unit, *FormatCell(Record.ToCell), Record.Damage);
+
+	case ETBSLogAction::Skip:
+		return FString::Printf(TEXT("%s: %s Skip"), Player, Unit);
+	}
+
+	return FString();
+}
+
+FArchive& operator<<(FArchive& Ar, FTBSActionLog& Log)
+{
+	uint32 Magic = ACTION_LOG_MAGIC;
+	uint32 Version = ACTION_LOG_VERSION;
+	Ar << Magic;
+	Ar << Version;
+	if (Ar.IsLoading() && (Magic != ACTION_LOG_MAGIC || Version != ACTION_LOG_VERSION))
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	Ar << Log.MatchSeed;
+	Ar << Log.MapSeed;
+	Ar << Log.GridSize;
+	Ar << Log.ObstaclePercentage;
+	Ar << Log.StartingPlayer;
+	Ar << Log.Records;
+	Ar << Log.TurnStarts;
+	return Ar;
+}
+
+bool FTBSActionLog::SaveToFile(const FString& FileName)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	Writer << *this;
+	return FFileHelper::SaveArrayToFile(Bytes, *FileName);
+}
+
+bool FTBSActionLog::LoadFromFile(const FString& FileName)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FileName))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	Reader << *this;
+	if (Reader.IsError())
+	{
+		Reset();
+		return false;
+	}
+	return true;
+}
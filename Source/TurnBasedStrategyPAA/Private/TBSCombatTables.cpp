@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSCombatTables.h"
+
+// Tabulated attacker types, in EUnitType order after NONE
+static constexpr int32 NUM_TYPES = 2;
+static constexpr int32 TYPE_MIN_DAMAGE[NUM_TYPES] = { FTBSCombatTables::BRAWLER_MIN_DAMAGE, FTBSCombatTables::SNIPER_MIN_DAMAGE };
+static constexpr int32 TYPE_MAX_DAMAGE[NUM_TYPES] = { FTBSCombatTables::BRAWLER_MAX_DAMAGE, FTBSCombatTables::SNIPER_MAX_DAMAGE };
+
+static_assert(FTBSCombatTables::BRAWLER_MAX_DAMAGE <= FTBSCombatTables::SNIPER_MAX_DAMAGE, "MAX_TOTAL_DAMAGE assumes Snipers hit hardest");
+static_assert(FTBSCombatTables::SNIPER_MAX_HEALTH <= FTBSCombatTables::MAX_HEALTH, "Every unit health must be tabulated");
+
+struct FCombatTableData
+{
+	// [Type][Hits][Total damage]
+	float Damage[NUM_TYPES][FTBSCombatTables::MAX_HITS + 1][FTBSCombatTables::MAX_TOTAL_DAMAGE + 1] = {};
+
+	// [Type][Hits][Health]
+	float Kill[NUM_TYPES][FTBSCombatTables::MAX_HITS + 1][FTBSCombatTables::MAX_HEALTH + 1] = {};
+
+	// [Type][Health]
+	float ExpectedDamage[NUM_TYPES][FTBSCombatTables::MAX_HEALTH + 1] = {};
+
+	// [Health]
+	float CounterKill[FTBSCombatTables::MAX_HEALTH + 1] = {};
+	float ExpectedCounterDamage[FTBSCombatTables::MAX_HEALTH + 1] = {};
+};
+
+// Convolves the uniform roll with itself once per hit, then sums the tails
+static constexpr FCombatTableData BuildCombatTables()
+{
+	constexpr int32 MaxHits = FTBSCombatTables::MAX_HITS;
+	constexpr int32 MaxDamage = FTBSCombatTables::MAX_TOTAL_DAMAGE;
+	constexpr int32 MaxHealth = FTBSCombatTables::MAX_HEALTH;
+
+	FCombatTableData Data;
+
+	for (int32 Type = 0; Type < NUM_TYPES; Type++)
+	{
+		const int32 Min = TYPE_MIN_DAMAGE[Type];
+		const int32 Max = TYPE_MAX_DAMAGE[Type];
+		const double RollProbability = 1.0 / (Max - Min + 1);
+
+		double Damage[MaxHits + 1][MaxDamage + 1] = {};
+		Damage[0][0] = 1.0;
+		for (int32 Hits = 1; Hits <= MaxHits; Hits++)
+		{
+			for (int32 Total = Hits * Min; Total <= Hits * Max; Total++)
+			{
+				for (int32 Roll = Min; Roll <= Max && Roll <= Total; Roll++)
+				{
+					Damage[Hits][Total] += Damage[Hits - 1][Total - Roll] * RollProbability;
+				}
+			}
+		}
+
+		for (int32 Hits = 0; Hits <= MaxHits; Hits++)
+		{
+			double Tail = 0.0;
+			for (int32 Total = MaxDamage; Total >= 0; Total--)
+			{
+				Data.Damage[Type][Hits][Total] = static_cast<float>(Damage[Hits][Total]);
+				Tail += Damage[Hits][Total];
+				if (Total <= MaxHealth)
+				{
+					Data.Kill[Type][Hits][Total] = static_cast<float>(Tail);
+				}
+			}
+		}
+
+		for (int32 Health = 0; Health <= MaxHealth; Health++)
+		{
+			double Expected = 0.0;
+			for (int32 Roll = Min; Roll <= Max; Roll++)
+			{
+				Expected += (Roll < Health ? Roll : Health) * RollProbability;
+			}
+			Data.ExpectedDamage[Type][Health] = static_cast<float>(Expected);
+		}
+	}
+
+	const double CounterProbability = 1.0 / (FTBSCombatTables::COUNTER_MAX_DAMAGE - FTBSCombatTables::COUNTER_MIN_DAMAGE + 1);
+	for (int32 Health = 0; Health <= MaxHealth; Health++)
+	{
+		double Kill = 0.0;
+		double Expected = 0.0;
+		for (int32 Roll = FTBSCombatTables::COUNTER_MIN_DAMAGE; Roll <= FTBSCombatTables::COUNTER_MAX_DAMAGE; Roll++)
+		{
+			Kill += (Roll >= Health) ? CounterProbability : 0.0;
+			Expected += (Roll < Health ? Roll : Health) * CounterProbability;
+		}
+		Data.CounterKill[Health] = static_cast<float>(Kill);
+		Data.ExpectedCounterDamage[Health] = static_cast<float>(Expected);
+	}
+
+	return Data;
+}
+
+static constexpr FCombatTableData COMBAT_TABLES = BuildCombatTables();
+
+static constexpr bool IsNearly(const float A, const float B)
+{
+	return A - B < 1e-6f && B - A < 1e-6f;
+}
+
+// A Sniper always kills 4 health and kills 8 health one shot in five, a Brawler never kills 7 health in one hit
+static_assert(IsNearly(COMBAT_TABLES.Kill[1][1][4], 1.0f) && IsNearly(COMBAT_TABLES.Kill[1][1][8], 0.2f), "Sniper kill odds");
+static_assert(IsNearly(COMBAT_TABLES.Kill[0][1][6], 1.0f / 6.0f) && COMBAT_TABLES.Kill[0][1][7] == 0.0f, "Brawler kill odds");
+static_assert(IsNearly(COMBAT_TABLES.Kill[0][2][12], 1.0f / 36.0f), "Two Brawler hits");
+static_assert(IsNearly(COMBAT_TABLES.ExpectedCounterDamage[3], 2.0f) && IsNearly(COMBAT_TABLES.CounterKill[1], 1.0f), "Counter-damage odds");
+
+// Table row of a type, INDEX_NONE if it isn't tabulated
+static FORCEINLINE int32 GetTypeIndex(const EUnitType Type)
+{
+	switch (Type)
+	{
+	case EUnitType::BRAWLER:
+		return 0;
+	case EUnitType::SNIPER:
+		return 1;
+	default:
+		return INDEX_NONE;
+	}
+}
+
+bool FTBSCombatTables::IsTabulated(const EUnitType AttackerType, const int32 MinDamage, const int32 MaxDamage)
+{
+	const int32 Type = GetTypeIndex(AttackerType);
+	return Type != INDEX_NONE && TYPE_MIN_DAMAGE[Type] == MinDamage && TYPE_MAX_DAMAGE[Type] == MaxDamage;
+}
+
+float FTBSCombatTables::GetDamageProbability(const EUnitType AttackerType, const int32 NumHits, const int32 Damage)
+{
+	const int32 Type = GetTypeIndex(AttackerType);
+	if (Type == INDEX_NONE || NumHits < 0 || NumHits > MAX_HITS || Damage < 0 || Damage > MAX_TOTAL_DAMAGE)
+	{
+		return 0.0f;
+	}
+	return COMBAT_TABLES.Damage[Type][NumHits][Damage];
+}
+
+float FTBSCombatTables::GetKillProbability(const EUnitType AttackerType, const int32 Health, const int32 NumHits)
+{
+	const int32 Type = GetTypeIndex(AttackerType);
+	if (Type == INDEX_NONE)
+	{
+		return 0.0f;
+	}
+	return COMBAT_TABLES.Kill[Type][FMath::Clamp(NumHits, 0, MAX_HITS)][FMath::Clamp(Health, 0, MAX_HEALTH)];
+}
+
+float FTBSCombatTables::GetHealthAfterProbability(const EUnitType AttackerType, const int32 Health, const int32 NumHits, const int32 ResultHealth)
+{
+	if (ResultHealth <= 0)
+	{
+		return GetKillProbability(AttackerType, Health, NumHits);
+	}
+	return (ResultHealth <= Health) ? GetDamageProbability(AttackerType, NumHits, Health - ResultHealth) : 0.0f;
+}
+
+float FTBSCombatTables::GetExpectedDamage(const EUnitType AttackerType, const int32 Health)
+{
+	const int32 Type = GetTypeIndex(AttackerType);
+	if (Type == INDEX_NONE)
+	{
+		return 0.0f;
+	}
+	return COMBAT_TABLES.ExpectedDamage[Type][FMath::Clamp(Health, 0, MAX_HEALTH)];
+}
+
+float FTBSCombatTables::GetCounterKillProbability(const int32 Health)
+{
+	return COMBAT_TABLES.CounterKill[FMath::Clamp(Health, 0, MAX_HEALTH)];
+}
+
+float FTBSCombatTables::GetExpectedCounterDamage(const int32 Health)
+{
+	return COMBAT_TABLES.ExpectedCounterDamage[FMath::Clamp(Health, 0, MAX_HEALTH)];
+}
@@ -0,0 +1,399 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSGameState.h"
+
+// What a Zobrist key stands for
+enum class EZobristFeature : uint64
+{
+	BoardSize,
+	Obstacle,
+	SideToMove,
+	UnitCell,
+	UnitHealth,
+	UnitMoved,
+	UnitAttacked
+};
+
+// Random key of a feature and its arguments. Keys are hashed on the fly (SplitMix64) instead of read
+// from tables, so they don't depend on the board size nor cost a cache miss.
+static FORCEINLINE uint64 ZobristKey(const EZobristFeature Feature, const uint32 A = 0, const uint32 B = 0)
+{
+	uint64 Key = ((static_cast<uint64>(B) << 32) | (static_cast<uint64>(A) << 3) | static_cast<uint64>(Feature)) + 1;
+	Key *= 0x9E3779B97F4A7C15ull;
+	Key = (Key ^ (Key >> 30)) * 0xBF58476D1CE4E5B9ull;
+	Key = (Key ^ (Key >> 27)) * 0x94D049BB133111EBull;
+	return Key ^ (Key >> 31);
+}
+
+// Index, type and owner of a unit, so models captured in a different order don't share keys
+static FORCEINLINE uint32 GetUnitTag(const int32 UnitIndex, const FTBSUnitState& Unit)
+{
+	return static_cast<uint32>(UnitIndex) | (static_cast<uint32>(Unit.Type) << 8) | (static_cast<uint32>(Unit.Owner) << 16);
+}
+
+FTBSUnitState FTBSUnitState::MakeDefault(const EUnitType InType, const int32 InOwner, const int32 InCell)
+{
+	const bool bBrawler = (InType == EUnitType::BRAWLER);
+
+	FTBSUnitState Unit;
+	Unit.Type = InType;
+	Unit.Owner = static_cast<int8>(InOwner);
+	Unit.Cell = InCell;
+	Unit.MaxHealth = bBrawler ? FTBSCombatTables::BRAWLER_MAX_HEALTH : FTBSCombatTables::SNIPER_MAX_HEALTH;
+	Unit.Health = Unit.MaxHealth;
+	Unit.MovementRange = bBrawler ? FTBSCombatTables::BRAWLER_MOVEMENT_RANGE : FTBSCombatTables::SNIPER_MOVEMENT_RANGE;
+	Unit.AttackRange = bBrawler ? FTBSCombatTables::BRAWLER_ATTACK_RANGE : FTBSCombatTables::SNIPER_ATTACK_RANGE;
+	Unit.MinDamage = bBrawler ? FTBSCombatTables::BRAWLER_MIN_DAMAGE : FTBSCombatTables::SNIPER_MIN_DAMAGE;
+	Unit.MaxDamage = bBrawler ? FTBSCombatTables::BRAWLER_MAX_DAMAGE : FTBSCombatTables::SNIPER_MAX_DAMAGE;
+	return Unit;
+}
+
+FTBSAction FTBSAction::MakeMove(const int32 InUnit, const int32 InCell)
+{
+	FTBSAction Action;
+	Action.Type = ETBSActionType::Move;
+	Action.Unit = static_cast<int8>(InUnit);
+	Action.Cell = InCell;
+	return Action;
+}
+
+FTBSAction FTBSAction::MakeAttack(const int32 InUnit, const int32 InTarget)
+{
+	FTBSAction Action;
+	Action.Type = ETBSActionType::Attack;
+	Action.Unit = static_cast<int8>(InUnit);
+	Action.Target = static_cast<int8>(InTarget);
+	return Action;
+}
+
+FTBSAction FTBSAction::MakeEndTurn()
+{
+	return FTBSAction();
+}
+
+FTBSGameState::FTBSGameState()
+	: Size(0)
+	, SideToMove(0)
+	, Key(0)
+{
+	AliveCount[0] = AliveCount[1] = 0;
+}
+
+void FTBSGameState::Init(const int32 InSize)
+{
+	Size = InSize;
+	SideToMove = 0;
+	Cells.Init(EMPTY_CELL, Size * Size);
+	Units.Reset();
+	AliveCount[0] = AliveCount[1] = 0;
+	Key = ZobristKey(EZobristFeature::BoardSize, Size);
+}
+
+void FTBSGameState::SetObstacle(const int32 Index)
+{
+	if (Cells[Index] != OBSTACLE_CELL)
+	{
+		Cells[Index] = OBSTACLE_CELL;
+		Key ^= ZobristKey(EZobristFeature::Obstacle, Index);
+	}
+}
+
+void FTBSGameState::SetSideToMove(const int32 Side)
+{
+	if (Side != SideToMove)
+	{
+		Key ^= ZobristKey(EZobristFeature::SideToMove);
+		SideToMove = Side;
+	}
+}
+
+int32 FTBSGameState::AddUnit(const FTBSUnitState& Unit)
+{
+	if (Units.Num() >= MAX_UNITS || Unit.Owner < 0 || Unit.Owner >= NUM_PLAYERS || !Cells.IsValidIndex(Unit.Cell) || !IsWalkable(Unit.Cell))
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 UnitIndex = Units.Add(Unit);
+	if (Unit.IsAlive())
+	{
+		Cells[Unit.Cell] = static_cast<int8>(UnitIndex);
+		AliveCount[Unit.Owner]++;
+	}
+	Key ^= GetUnitKey(UnitIndex);
+	return UnitIndex;
+}
+
+uint64 FTBSGameState::GetUnitKey(const int32 UnitIndex) const
+{
+	const FTBSUnitState& Unit = Units[UnitIndex];
+	const uint32 Tag = GetUnitTag(UnitIndex, Unit);
+
+	uint64 UnitKey = ZobristKey(EZobristFeature::UnitHealth, Tag, Unit.Health);
+	UnitKey ^= Unit.IsAlive() ? ZobristKey(EZobristFeature::UnitCell, Tag, Unit.Cell) : 0;
+	UnitKey ^= Unit.bMoved ? ZobristKey(EZobristFeature::UnitMoved, Tag) : 0;
+	UnitKey ^= Unit.bAttacked ? ZobristKey(EZobristFeature::UnitAttacked, Tag) : 0;
+	return UnitKey;
+}
+
+uint64 FTBSGameState::ComputeKey() const
+{
+	uint64 FullKey = ZobristKey(EZobristFeature::BoardSize, Size);
+	for (int32 Index = 0; Index < Cells.Num(); Index++)
+	{
+		FullKey ^= (Cells[Index] == OBSTACLE_CELL) ? ZobristKey(EZobristFeature::Obstacle, Index) : 0;
+	}
+	for (int32 UnitIndex = 0; UnitIndex < Units.Num(); UnitIndex++)
+	{
+		FullKey ^= GetUnitKey(UnitIndex);
+	}
+	FullKey ^= (SideToMove != 0) ? ZobristKey(EZobristFeature::SideToMove) : 0;
+	return FullKey;
+}
+
+int32 FTBSGameState::GetWinner() const
+{
+	if (!IsGameOver())
+	{
+		return INDEX_NONE;
+	}
+
+	if (AliveCount[0] == AliveCount[1])
+	{
+		return DRAW;
+	}
+
+	return (AliveCount[0] > 0) ? 0 : 1;
+}
+
+bool FTBSGameState::CanAttack(const int32 AttackerIndex, const int32 TargetIndex) const
+{
+	const FTBSUnitState& Attacker = Units[AttackerIndex];
+	const FTBSUnitState& Target = Units[TargetIndex];
+
+	return Attacker.IsAlive() && Target.IsAlive() && Attacker.Owner != Target.Owner &&
+		GetCellDistance(Attacker.Cell, Target.Cell) <= Attacker.AttackRange;
+}
+
+bool FTBSGameState::HasCounterDamage(const int32 AttackerIndex, const int32 TargetIndex) const
+{
+	const FTBSUnitState& Attacker = Units[AttackerIndex];
+	const FTBSUnitState& Target = Units[TargetIndex];
+
+	if (Attacker.Type != EUnitType::SNIPER)
+	{
+		return false;
+	}
+
+	// Same rule as ASniper::Attack
+	return Target.Type == EUnitType::SNIPER ||
+		(Target.Type == EUnitType::BRAWLER && GetCellDistance(Attacker.Cell, Target.Cell) <= 1);
+}
+
+void FTBSGameState::FindMoveCells(const int32 UnitIndex, FGridBFS& BFS, TArray<int32>& OutCells) const
+{
+	OutCells.Reset();
+
+	const FTBSUnitState& Unit = Units[UnitIndex];
+	if (!Unit.IsAlive() || Unit.bMoved || Unit.MovementRange <= 0)
+	{
+		return;
+	}
+
+	BFS.Run(Unit.Cell, Unit.MovementRange, [this](const int32 Index)
+		{
+			return Cells[Index] == EMPTY_CELL;
+		});
+
+	// The first visited cell is the start
+	const TArrayView<const int32> Visited = BFS.GetVisitedCells();
+	OutCells.Append(Visited.GetData() + 1, Visited.Num() - 1);
+}
+
+void FTBSGameState::GenerateActions(FGridBFS& BFS, TArray<FTBSAction>& OutActions) const
+{
+	OutActions.Reset();
+
+	if (IsGameOver())
+	{
+		return;
+	}
+
+	for (int32 UnitIndex = 0; UnitIndex < Units.Num(); UnitIndex++)
+	{
+		const FTBSUnitState& Unit = Units[UnitIndex];
+		if (Unit.Owner != SideToMove || !Unit.IsAlive())
+		{
+			continue;
+		}
+
+		if (!Unit.bAttacked)
+		{
+			for (int32 TargetIndex = 0; TargetIndex < Units.Num(); TargetIndex++)
+			{
+				if (CanAttack(UnitIndex, TargetIndex))
+				{
+					OutActions.Add(FTBSAction::MakeAttack(UnitIndex, TargetIndex));
+				}
+			}
+		}
+
+		if (!Unit.bMoved && Unit.MovementRange > 0)
+		{
+			BFS.Run(Unit.Cell, Unit.MovementRange, [this](const int32 Index)
+				{
+					return Cells[Index] == EMPTY_CELL;
+				});
+
+			const TArrayView<const int32> Visited = BFS.GetVisitedCells();
+			for (int32 Slot = 1; Slot < Visited.Num(); Slot++)
+			{
+				OutActions.Add(FTBSAction::MakeMove(UnitIndex, Visited[Slot]));
+			}
+		}
+	}
+
+	OutActions.Add(FTBSAction::MakeEndTurn());
+}
+
+void FTBSGameState::MakeAction(const FTBSAction& Action, const int32 Damage, const int32 CounterDamage, FTBSUndo& OutUndo)
+{
+	OutUndo.Action = Action;
+	OutUndo.Flags = PackFlags();
+	OutUndo.SideToMove = SideToMove;
+	OutUndo.Key = Key;
+
+	switch (Action.Type)
+	{
+	case ETBSActionType::Move:
+	{
+		FTBSUnitState& Unit = Units[Action.Unit];
+		OutUndo.FromCell = Unit.Cell;
+
+		const uint32 Tag = GetUnitTag(Action.Unit, Unit);
+		Key ^= ZobristKey(EZobristFeature::UnitCell, Tag, Unit.Cell) ^ ZobristKey(EZobristFeature::UnitCell, Tag, Action.Cell);
+		Key ^= Unit.bMoved ? 0 : ZobristKey(EZobristFeature::UnitMoved, Tag);
+
+		Cells[Unit.Cell] = EMPTY_CELL;
+		Cells[Action.Cell] = Action.Unit;
+		Unit.Cell = Action.Cell;
+		Unit.bMoved = true;
+		break;
+	}
+
+	case ETBSActionType::Attack:
+	{
+		OutUndo.UnitHealth = Units[Action.Unit].Health;
+		OutUndo.TargetHealth = Units[Action.Target].Health;
+
+		// The counter-damage rule looks at the distance, so check it before the target can leave the board
+		const bool bCounter = HasCounterDamage(Action.Unit, Action.Target);
+
+		ApplyDamage(Action.Target, Damage);
+		if (bCounter)
+		{
+			ApplyDamage(Action.Unit, CounterDamage);
+		}
+
+		FTBSUnitState& Unit = Units[Action.Unit];
+		Key ^= Unit.bAttacked ? 0 : ZobristKey(EZobristFeature::UnitAttacked, GetUnitTag(Action.Unit, Unit));
+		Unit.bAttacked = true;
+		break;
+	}
+
+	case ETBSActionType::EndTurn:
+	{
+		// Like ATBS_GameMode::EndTurn: the next player's units get their actions back
+		SideToMove = (SideToMove + 1) % NUM_PLAYERS;
+		Key ^= ZobristKey(EZobristFeature::SideToMove);
+		for (int32 UnitIndex = 0; UnitIndex < Units.Num(); UnitIndex++)
+		{
+			FTBSUnitState& Unit = Units[UnitIndex];
+			if (Unit.Owner == SideToMove)
+			{
+				const uint32 Tag = GetUnitTag(UnitIndex, Unit);
+				Key ^= Unit.bMoved ? ZobristKey(EZobristFeature::UnitMoved, Tag) : 0;
+				Key ^= Unit.bAttacked ? ZobristKey(EZobristFeature::UnitAttacked, Tag) : 0;
+				Unit.bMoved = false;
+				Unit.bAttacked = false;
+			}
+		}
+		break;
+	}
+	}
+}
+
+void FTBSGameState::MakeExpectedAction(const FTBSAction& Action, FTBSUndo& OutUndo)
+{
+	const int32 Damage = (Action.Type == ETBSActionType::Attack) ? GetExpectedDamage(Units[Action.Unit]) : 0;
+	MakeAction(Action, Damage, GetExpectedCounterDamage(), OutUndo);
+}
+
+void FTBSGameState::UnmakeAction(const FTBSUndo& Undo)
+{
+	const FTBSAction& Action = Undo.Action;
+
+	switch (Action.Type)
+	{
+	case ETBSActionType::Move:
+	{
+		FTBSUnitState& Unit = Units[Action.Unit];
+		Cells[Unit.Cell] = EMPTY_CELL;
+		Cells[Undo.FromCell] = Action.Unit;
+		Unit.Cell = Undo.FromCell;
+		break;
+	}
+
+	case ETBSActionType::Attack:
+		RestoreHealth(Action.Target, Undo.TargetHealth);
+		RestoreHealth(Action.Unit, Undo.UnitHealth);
+		break;
+
+	case ETBSActionType::EndTurn:
+		break;
+	}
+
+	SideToMove = Undo.SideToMove;
+	Key = Undo.Key;
+	for (int32 UnitIndex = 0; UnitIndex < Units.Num(); UnitIndex++)
+	{
+		Units[UnitIndex].bMoved = (Undo.Flags >> (UnitIndex * 2)) & 1u;
+		Units[UnitIndex].bAttacked = (Undo.Flags >> (UnitIndex * 2)) & 2u;
+	}
+}
+
+void FTBSGameState::ApplyDamage(const int32 UnitIndex, const int32 Amount)
+{
+	FTBSUnitState& Unit = Units[UnitIndex];
+	if (!Unit.IsAlive())
+	{
+		return;
+	}
+
+	const uint32 Tag = GetUnitTag(UnitIndex, Unit);
+	Key ^= ZobristKey(EZobristFeature::UnitHealth, Tag, Unit.Health);
+	Unit.Health = FMath::Clamp(Unit.Health - Amount, 0, Unit.MaxHealth);
+	Key ^= ZobristKey(EZobristFeature::UnitHealth, Tag, Unit.Health);
+
+	// A dead unit frees its cell, as AUnit::ReceiveDamage does
+	if (!Unit.IsAlive())
+	{
+		Key ^= ZobristKey(EZobristFeature::UnitCell, Tag, Unit.Cell);
+		Cells[Unit.Cell] = EMPTY_CELL;
+		AliveCount[Unit.Owner]--;
+	}
+}
+
+// Only called by UnmakeAction, which puts the key back as a whole
+void FTBSGameState::RestoreHealth(const int32 UnitIndex, const int32 Health)
+{
+	FTBSUnitState& Unit = Units[UnitIndex];
+	if (!Unit.IsAlive() && Health > 0)
+	{
+		Cells[Unit.Cell] = static_cast<int8>(UnitIndex);
+		AliveCount[Unit.Owner]++;
+	}
+
+	Unit.Health = Health;
+}
@@ -0,0 +1,296 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSMatchSimulator.h"
+#include "Async/ParallelFor.h"
+
+void FTBSMatchSimulator::Play(const FTBSMatchSettings& InSettings, FTBSMatchResult& OutResult, FTBSActionLog* OutLog)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	Settings = InSettings;
+	Log = OutLog;
+	OutResult = FTBSMatchResult();
+	Random.Initialize(Settings.Seed);
+
+	// Same map as a round of ATBS_GameMode with this seed
+	FMapGenerator::Generate(Settings.Seed, Settings.GridSize, Settings.ObstaclePercentage, Layout);
+	State.Init(Settings.GridSize);
+	Layout.Obstacles.ForEachSetBit([this](const int32 Index)
+		{
+			State.SetObstacle(Index);
+		});
+
+	if (BFS.GetSize() != Settings.GridSize)
+	{
+		BFS.Init(Settings.GridSize);
+	}
+
+	// A match must play the same whatever the simulator played before
+	Search.ClearTable();
+
+	// The coin toss winner places first and plays first
+	OutResult.StartingPlayer = Random.GetCoinToss().RandRange(0, FTBSGameState::NUM_PLAYERS - 1);
+	if (Log)
+	{
+		Log->Reset();
+		Log->BeginRound(Settings.Seed, Settings.Seed, Settings.GridSize, Settings.ObstaclePercentage);
+		Log->SetStartingPlayer(OutResult.StartingPlayer);
+	}
+
+	PlaceUnits(OutResult.StartingPlayer);
+	State.SetSideToMove(OutResult.StartingPlayer);
+
+	while (!State.IsGameOver() && OutResult.NumTurns < Settings.MaxTurns)
+	{
+		const int32 Side = State.GetSideToMove();
+		const double TurnStartTime = FPlatformTime::Seconds();
+
+		if (Log)
+		{
+			Log->BeginTurn();
+		}
+
+		PlayTurn(Settings.Players[Side], OutResult);
+
+		OutResult.ThinkSeconds[Side] += FPlatformTime::Seconds() - TurnStartTime;
+		OutResult.NumTurns++;
+	}
+
+	OutResult.bTurnLimit = !State.IsGameOver();
+	OutResult.Winner = OutResult.bTurnLimit ? FTBSGameState::DRAW : State.GetWinner();
+	OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+}
+
+void FTBSMatchSimulator::PlayBatch(const FTBSMatchSettings& Settings, const int32 NumMatches, TArray<FTBSMatchResult>& OutResults)
+{
+	OutResults.SetNum(NumMatches);
+
+	// A root-parallel search inside every match would oversubscribe the task pool
+	FTBSMatchSettings BatchSettings = Settings;
+	for (FTBSSimPlayer& Player : BatchSettings.Players)
+	{
+		Player.MonteCarlo.NumTrees = 1;
+	}
+
+	// One simulator per worker, reused for all the matches the worker plays
+	TArray<FTBSMatchSimulator> Simulators;
+	ParallelForWithTaskContext(Simulators, NumMatches, [&BatchSettings, &OutResults](FTBSMatchSimulator& Simulator, const int32 MatchIndex)
+		{
+			FTBSMatchSettings MatchSettings = BatchSettings;
+			MatchSettings.Seed = BatchSettings.Seed + MatchIndex;
+			Simulator.Play(MatchSettings, OutResults[MatchIndex]);
+		});
+}
+
+void FTBSMatchSimulator::PlaceUnits(const int32 StartingPlayer)
+{
+	// Types still to place, per player
+	TArray<EUnitType, TInlineAllocator<2>> ToPlace[FTBSGameState::NUM_PLAYERS];
+	for (int32 Player = 0; Player < FTBSGameState::NUM_PLAYERS; Player++)
+	{
+		ToPlace[Player].Add(EUnitType::BRAWLER);
+		ToPlace[Player].Add(EUnitType::SNIPER);
+	}
+
+	const int32 NumUnits = FTBSGameState::NUM_PLAYERS * ToPlace[0].Num();
+	for (int32 Placed = 0; Placed < NumUnits; Placed++)
+	{
+		const int32 Player = (StartingPlayer + Placed) % FTBSGameState::NUM_PLAYERS;
+
+		Cells.Reset();
+		for (int32 Index = 0; Index < State.GetNumCells(); Index++)
+		{
+			if (State.IsWalkable(Index))
+			{
+				Cells.Add(Index);
+			}
+		}
+
+		if (Cells.Num() == 0)
+		{
+			return;
+		}
+
+		FTBSRandom& PlayerRandom = Random.GetAI(Player);
+		const int32 TypeSlot = PlayerRandom.RandRange(0, ToPlace[Player].Num() - 1);
+		const int32 Cell = Cells[PlayerRandom.RandRange(0, Cells.Num() - 1)];
+		State.AddUnit(FTBSUnitState::MakeDefault(ToPlace[Player][TypeSlot], Player, Cell));
+		if (Log)
+		{
+			FTBSLogRecord Record;
+			Record.Action = ETBSLogAction::Place;
+			Record.Player = static_cast<uint8>(Player);
+			Record.Unit = ToPlace[Player][TypeSlot];
+			Record.FromCell = static_cast<uint16>(Cell);
+			Record.ToCell = static_cast<uint16>(Cell);
+			Log->Add(Record);
+		}
+		ToPlace[Player].RemoveAt(TypeSlot);
+	}
+}
+
+void FTBSMatchSimulator::PlayTurn(const FTBSSimPlayer& Player, FTBSMatchResult& OutResult)
+{
+	switch (Player.Agent)
+	{
+	case ETBSSimAgent::Random:
+		PlayRandomTurn(OutResult);
+		break;
+
+	case ETBSSimAgent::AlphaBeta:
+	case ETBSSimAgent::MonteCarlo:
+		PlaySearchTurn(Player, OutResult);
+		break;
+	}
+}
+
+void FTBSMatchSimulator::PlayRandomTurn(FTBSMatchResult& OutResult)
+{
+	const int32 Side = State.GetSideToMove();
+	FTBSRandom& SideRandom = Random.GetAI(Side);
+
+	Order.Reset();
+	for (int32 UnitIndex = 0; UnitIndex < State.GetNumUnits(); UnitIndex++)
+	{
+		if (State.GetUnit(UnitIndex).Owner == Side)
+		{
+			Order.Add(UnitIndex);
+		}
+	}
+
+	// Units in random order: maybe attack, move somewhere, attack if it didn't
+	while (Order.Num() > 0 && !State.IsGameOver())
+	{
+		const int32 Slot = SideRandom.RandRange(0, Order.Num() - 1);
+		const int32 UnitIndex = Order[Slot];
+		Order.RemoveAt(Slot);
+
+		if (SideRandom.RandBool())
+		{
+			RandomAttack(UnitIndex, OutResult);
+		}
+
+		State.FindMoveCells(UnitIndex, BFS, Cells);
+		if (Cells.Num() > 0 && !State.IsGameOver())
+		{
+			ApplyAction(FTBSAction::MakeMove(UnitIndex, Cells[SideRandom.RandRange(0, Cells.Num() - 1)]), OutResult);
+			RandomAttack(UnitIndex, OutResult);
+		}
+	}
+
+	if (!State.IsGameOver())
+	{
+		ApplyAction(FTBSAction::MakeEndTurn(), OutResult);
+	}
+}
+
+void FTBSMatchSimulator::PlaySearchTurn(const FTBSSimPlayer& Player, FTBSMatchResult& OutResult)
+{
+	const int32 Side = State.GetSideToMove();
+	FTBSSearchResult Result;
+
+	for (int32 NumSearches = 0; NumSearches < Settings.MaxSearchesPerTurn; NumSearches++)
+	{
+		if (Player.Agent == ETBSSimAgent::MonteCarlo)
+		{
+			FTBSMonteCarloSettings MonteCarloSettings = Player.MonteCarlo;
+			MonteCarloSettings.Seed = Random.GetAI(Side).RandRange(0, MAX_int32 - 1);
+			MonteCarlo.Search(State, MonteCarloSettings, Result);
+		}
+		else
+		{
+			Search.Search(State, Player.Search, Result);
+		}
+
+		// Same protocol as ATBS_SmartAI: play the plan, search again after every real roll
+		for (const FTBSAction& Action : Result.Plan)
+		{
+			if (!IsLegal(Action))
+			{
+				break;
+			}
+
+			ApplyAction(Action, OutResult);
+			if (State.IsGameOver() || State.GetSideToMove() != Side)
+			{
+				return;
+			}
+
+			if (Action.Type == ETBSActionType::Attack)
+			{
+				break;
+			}
+		}
+	}
+
+	ApplyAction(FTBSAction::MakeEndTurn(), OutResult);
+}
+
+void FTBSMatchSimulator::ApplyAction(const FTBSAction& Action, FTBSMatchResult& OutResult)
+{
+	int32 Damage = 0;
+	int32 CounterDamage = 0;
+	if (Action.Type == ETBSActionType::Attack)
+	{
+		const FTBSUnitState& Unit = State.GetUnit(Action.Unit);
+		Damage = Random.GetCombat().RandRange(Unit.MinDamage, Unit.MaxDamage);
+		CounterDamage = Random.GetCombat().RandRange(FTBSGameState::COUNTER_MIN_DAMAGE, FTBSGameState::COUNTER_MAX_DAMAGE);
+	}
+
+	if (Log && Action.Type != ETBSActionType::EndTurn)
+	{
+		const FTBSUnitState& Unit = State.GetUnit(Action.Unit);
+
+		FTBSLogRecord Record;
+		Record.Player = static_cast<uint8>(Unit.Owner);
+		Record.Unit = Unit.Type;
+		Record.FromCell = static_cast<uint16>(Unit.Cell);
+		if (Action.Type == ETBSActionType::Move)
+		{
+			Record.Action = ETBSLogAction::Move;
+			Record.ToCell = static_cast<uint16>(Action.Cell);
+		}
+		else
+		{
+			Record.Action = ETBSLogAction::Attack;
+			Record.ToCell = static_cast<uint16>(State.GetUnit(Action.Target).Cell);
+			Record.Damage = static_cast<uint8>(Damage);
+			Record.CounterDamage = State.HasCounterDamage(Action.Unit, Action.Target) ? static_cast<uint8>(CounterDamage) : 0;
+		}
+		Log->Add(Record);
+	}
+
+	FTBSUndo Undo;
+	State.MakeAction(Action, Damage, CounterDamage, Undo);
+	OutResult.NumActions++;
+}
+
+void FTBSMatchSimulator::RandomAttack(const int32 UnitIndex, FTBSMatchResult& OutResult)
+{
+	const FTBSUnitState& Unit = State.GetUnit(UnitIndex);
+	if (!Unit.IsAlive() || Unit.bAttacked)
+	{
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<FTBSGameState::MAX_UNITS>> Targets;
+	for (int32 TargetIndex = 0; TargetIndex < State.GetNumUnits(); TargetIndex++)
+	{
+		if (State.CanAttack(UnitIndex, TargetIndex))
+		{
+			Targets.Add(TargetIndex);
+		}
+	}
+
+	if (Targets.Num() > 0)
+	{
+		ApplyAction(FTBSAction::MakeAttack(UnitIndex, Targets[Random.GetAI(Unit.Owner).RandRange(0, Targets.Num() - 1)]), OutResult);
+	}
+}
+
+bool FTBSMatchSimulator::IsLegal(const FTBSAction& Action)
+{
+	State.GenerateActions(BFS, LegalActions);
+	return LegalActions.Contains(Action);
+}
@@ -0,0 +1,492 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSMonteCarlo.h"
+#include "Async/ParallelFor.h"
+
+// Edges a tree may hold, past this the leaves are only rolled out (about 6 MB per tree)
+static constexpr int32 MAX_EDGES_PER_TREE = 1 << 18;
+
+// Iterations between two looks at the clock
+static constexpr int32 ITERATIONS_PER_CLOCK_CHECK = 32;
+
+// Destinations a rollout looks at before moving a unit
+static constexpr int32 ROLLOUT_MOVE_SAMPLES = 4;
+
+// Evaluation points that make a position about 73% won (1 / (1 + e^-1))
+static constexpr float EVALUATION_SCALE = 300.0f;
+
+FTBSMonteCarloTree::FTBSMonteCarloTree()
+	: NumIterations(0)
+{
+}
+
+uint32 FTBSMonteCarloTree::GetAliveMask(const FTBSGameState& InState)
+{
+	uint32 Mask = 0;
+	for (int32 UnitIndex = 0; UnitIndex < InState.GetNumUnits(); UnitIndex++)
+	{
+		Mask |= InState.GetUnit(UnitIndex).IsAlive() ? (1u << UnitIndex) : 0u;
+	}
+	return Mask;
+}
+
+void FTBSMonteCarloTree::Reset(const FTBSGameState& Root, const FTBSMonteCarloSettings& InSettings, const int32 Seed)
+{
+	Settings = InSettings;
+	Random.Initialize(static_cast<uint32>(Seed));
+	NumIterations = 0;
+
+	if (BFS.GetSize() != Root.GetSize())
+	{
+		BFS.Init(Root.GetSize());
+	}
+
+	Nodes.Reset();
+	Edges.Reset();
+
+	FNode RootNode;
+	RootNode.AliveMask = GetAliveMask(Root);
+	Nodes.Add(RootNode);
+}
+
+int32 FTBSMonteCarloTree::FindOutcome(const int32 EdgeIndex, const uint32 AliveMask) const
+{
+	for (int32 NodeIndex = Edges[EdgeIndex].FirstOutcome; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].NextOutcome)
+	{
+		if (Nodes[NodeIndex].AliveMask == AliveMask)
+		{
+			return NodeIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FTBSMonteCarloTree::FindLikeliestOutcome(const int32 EdgeIndex) const
+{
+	int32 BestNode = INDEX_NONE;
+	for (int32 NodeIndex = Edges[EdgeIndex].FirstOutcome; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].NextOutcome)
+	{
+		if (BestNode == INDEX_NONE || Nodes[NodeIndex].Visits > Nodes[BestNode].Visits)
+		{
+			BestNode = NodeIndex;
+		}
+	}
+	return BestNode;
+}
+
+void FTBSMonteCarloTree::RunIteration(const FTBSGameState& Root)
+{
+	NumIterations++;
+
+	State = Root;
+	PathEdges.Reset();
+	PathNodes.Reset();
+
+	int32 NodeIndex = 0;
+	bool bExpanded = false;
+
+	// Selection: walk down the tree until a new node is added
+	while (!State.IsGameOver())
+	{
+		if (Nodes[NodeIndex].FirstEdge == INDEX_NONE)
+		{
+			if (Edges.Num() >= MAX_EDGES_PER_TREE)
+			{
+				break;
+			}
+			Expand(NodeIndex);
+			bExpanded = true;
+		}
+
+		// UCT, untried actions first in the order the expansion put them
+		const FNode& Node = Nodes[NodeIndex];
+		const float LogVisits = FMath::Loge(static_cast<float>(FMath::Max(Node.Visits, 1)));
+
+		int32 BestEdge = INDEX_NONE;
+		float BestValue = -MAX_flt;
+		for (int32 EdgeIndex = Node.FirstEdge; EdgeIndex < Node.FirstEdge + Node.NumEdges; EdgeIndex++)
+		{
+			const FEdge& Edge = Edges[EdgeIndex];
+			if (Edge.Visits == 0)
+			{
+				BestEdge = EdgeIndex;
+				break;
+			}
+
+			const float Value = Edge.Value / Edge.Visits + Settings.Exploration * FMath::Sqrt(LogVisits / Edge.Visits);
+			if (Value > BestValue)
+			{
+				BestValue = Value;
+				BestEdge = EdgeIndex;
+			}
+		}
+
+		PathNodes.Add(NodeIndex);
+		PathEdges.Add(BestEdge);
+		MakeRolledAction(Edges[BestEdge].Action);
+
+		// The rolls decide who survived, and so which node this is
+		const uint32 AliveMask = GetAliveMask(State);
+		int32 NextNode = FindOutcome(BestEdge, AliveMask);
+		if (NextNode == INDEX_NONE)
+		{
+			FNode Outcome;
+			Outcome.AliveMask = AliveMask;
+			Outcome.NextOutcome = Edges[BestEdge].FirstOutcome;
+			NextNode = Nodes.Add(Outcome);
+			Edges[BestEdge].FirstOutcome = NextNode;
+			bExpanded = true;
+		}
+
+		NodeIndex = NextNode;
+		if (bExpanded)
+		{
+			break;
+		}
+	}
+
+	const float Value = State.IsGameOver() ? ScoreState() : Rollout();
+
+	// Backup, every edge keeps the value for the player who took it
+	Nodes[NodeIndex].Visits++;
+	for (int32 Step = 0; Step < PathEdges.Num(); Step++)
+	{
+		FEdge& Edge = Edges[PathEdges[Step]];
+		Edge.Visits++;
+		Edge.Value += (Edge.Side == 0) ? Value : 1.0f - Value;
+		Nodes[PathNodes[Step]].Visits++;
+	}
+}
+
+void FTBSMonteCarloTree::Expand(const int32 NodeIndex)
+{
+	const int32 Side = State.GetSideToMove();
+	NewActions.Reset();
+
+	// Attacks first, killing blows before the rest
+	for (int32 UnitIndex = 0; UnitIndex < State.GetNumUnits(); UnitIndex++)
+	{
+		const FTBSUnitState& Unit = State.GetUnit(UnitIndex);
+		if (Unit.Owner != Side || !Unit.IsAlive() || Unit.bAttacked)
+		{
+			continue;
+		}
+
+		for (int32 TargetIndex = 0; TargetIndex < State.GetNumUnits(); TargetIndex++)
+		{
+			if (State.CanAttack(UnitIndex, TargetIndex))
+			{
+				const bool bKill = FTBSGameState::GetExpectedDamage(Unit) >= State.GetUnit(TargetIndex).Health;
+				NewActions.Insert(FTBSAction::MakeAttack(UnitIndex, TargetIndex), bKill ? 0 : NewActions.Num());
+			}
+		}
+	}
+
+	// Then the most promising destinations of every unit
+	for (int32 UnitIndex = 0; UnitIndex < State.GetNumUnits(); UnitIndex++)
+	{
+		if (State.GetUnit(UnitIndex).Owner != Side)
+		{
+			continue;
+		}
+
+		State.FindMoveCells(UnitIndex, BFS, MoveCells);
+
+		MoveScores.Reset();
+		MoveOrder.Reset();
+		for (int32 Slot = 0; Slot < MoveCells.Num(); Slot++)
+		{
+			MoveScores.Add(FTBSSearch::ScoreMoveCell(State, UnitIndex, MoveCells[Slot]));
+			MoveOrder.Add(Slot);
+		}
+
+		MoveOrder.Sort([this](const int32 A, const int32 B)
+			{
+				return MoveScores[A] > MoveScores[B];
+			});
+
+		const int32 NumKept = FMath::Min(FMath::Max(1, Settings.MaxMovesPerUnit), MoveCells.Num());
+		for (int32 Kept = 0; Kept < NumKept; Kept++)
+		{
+			NewActions.Add(FTBSAction::MakeMove(UnitIndex, MoveCells[MoveOrder[Kept]]));
+		}
+	}
+
+	NewActions.Add(FTBSAction::MakeEndTurn());
+
+	Nodes[NodeIndex].FirstEdge = Edges.Num();
+	Nodes[NodeIndex].NumEdges = NewActions.Num();
+	for (const FTBSAction& Action : NewActions)
+	{
+		FEdge Edge;
+		Edge.Action = Action;
+		Edge.Side = Side;
+		Edges.Add(Edge);
+	}
+}
+
+float FTBSMonteCarloTree::Rollout()
+{
+	for (int32 Turn = 0; Turn < Settings.RolloutTurns && !State.IsGameOver(); Turn++)
+	{
+		PlayRolloutTurn();
+	}
+
+	return ScoreState();
+}
+
+void FTBSMonteCarloTree::PlayRolloutTurn()
+{
+	const int32 Side = State.GetSideToMove();
+
+	for (int32 UnitIndex = 0; UnitIndex < State.GetNumUnits(); UnitIndex++)
+	{
+		if (State.GetUnit(UnitIndex).Owner != Side)
+		{
+			continue;
+		}
+
+		// Shoot from where we stand if there is something in range
+		RolloutAttack(UnitIndex);
+		if (State.IsGameOver())
+		{
+			return;
+		}
+
+		// Move to the best of a few random destinations, then attack from there
+		State.FindMoveCells(UnitIndex, BFS, MoveCells);
+		if (MoveCells.Num() > 0)
+		{
+			int32 BestCell = INDEX_NONE;
+			int32 BestScore = MIN_int32;
+			for (int32 Sample = 0; Sample < ROLLOUT_MOVE_SAMPLES; Sample++)
+			{
+				const int32 Cell = MoveCells[Random.RandRange(0, MoveCells.Num() - 1)];
+				const int32 Score = FTBSSearch::ScoreMoveCell(State, UnitIndex, Cell);
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					BestCell = Cell;
+				}
+			}
+
+			MakeRolledAction(FTBSAction::MakeMove(UnitIndex, BestCell));
+			RolloutAttack(UnitIndex);
+			if (State.IsGameOver())
+			{
+				return;
+			}
+		}
+	}
+
+	MakeRolledAction(FTBSAction::MakeEndTurn());
+}
+
+void FTBSMonteCarloTree::RolloutAttack(const int32 UnitIndex)
+{
+	const FTBSUnitState& Unit = State.GetUnit(UnitIndex);
+	if (!Unit.IsAlive() || Unit.bAttacked)
+	{
+		return;
+	}
+
+	// Likeliest kill first, the weakest target on equal odds
+	int32 BestTarget = INDEX_NONE;
+	float BestKillProbability = -1.0f;
+	for (int32 TargetIndex = 0; TargetIndex < State.GetNumUnits(); TargetIndex++)
+	{
+		if (!State.CanAttack(UnitIndex, TargetIndex))
+		{
+			continue;
+		}
+
+		const int32 TargetHealth = State.GetUnit(TargetIndex).Health;
+		const float KillProbability = FTBSCombatTables::GetKillProbability(Unit.Type, TargetHealth);
+		if (KillProbability > BestKillProbability ||
+			(KillProbability == BestKillProbability && TargetHealth < State.GetUnit(BestTarget).Health))
+		{
+			BestTarget = TargetIndex;
+			BestKillProbability = KillProbability;
+		}
+	}
+
+	if (BestTarget != INDEX_NONE)
+	{
+		MakeRolledAction(FTBSAction::MakeAttack(UnitIndex, BestTarget));
+	}
+}
+
+void FTBSMonteCarloTree::MakeRolledAction(const FTBSAction& Action)
+{
+	int32 Damage = 0;
+	int32 CounterDamage = 0;
+	if (Action.Type == ETBSActionType::Attack)
+	{
+		const FTBSUnitState& Unit = State.GetUnit(Action.Unit);
+		Damage = Random.RandRange(Unit.MinDamage, Unit.MaxDamage);
+		CounterDamage = Random.RandRange(FTBSGameState::COUNTER_MIN_DAMAGE, FTBSGameState::COUNTER_MAX_DAMAGE);
+	}
+
+	FTBSUndo Undo;
+	State.MakeAction(Action, Damage, CounterDamage, Undo);
+}
+
+float FTBSMonteCarloTree::ScoreState() const
+{
+	const int32 Winner = State.GetWinner();
+	if (Winner == 0)
+	{
+		return 1.0f;
+	}
+	if (Winner == 1)
+	{
+		return 0.0f;
+	}
+	if (Winner == FTBSGameState::DRAW)
+	{
+		return 0.5f;
+	}
+
+	return 1.0f / (1.0f + FMath::Exp(-FTBSSearch::Evaluate(State, 0) / EVALUATION_SCALE));
+}
+
+void FTBSMonteCarlo::Search(const FTBSGameState& Root, const FTBSMonteCarloSettings& Settings, FTBSSearchResult& OutResult)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const double Deadline = StartTime + Settings.TimeBudget;
+
+	OutResult = FTBSSearchResult();
+	if (Root.IsGameOver())
+	{
+		return;
+	}
+
+	const int32 NumTrees = (Settings.NumTrees > 0) ? Settings.NumTrees : FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Trees.SetNum(NumTrees);
+
+	// Root parallelism: the trees share nothing but the root, no locking while searching
+	ParallelFor(NumTrees, [this, &Root, &Settings, Deadline](const int32 TreeIndex)
+		{
+			FTBSMonteCarloTree& Tree = Trees[TreeIndex];
+			Tree.Reset(Root, Settings, Settings.Seed + TreeIndex * 7919);
+
+			if (Settings.MaxIterations > 0)
+			{
+				for (int32 Iteration = 0; Iteration < Settings.MaxIterations; Iteration++)
+				{
+					Tree.RunIteration(Root);
+				}
+				return;
+			}
+
+			do
+			{
+				for (int32 Iteration = 0; Iteration < ITERATIONS_PER_CLOCK_CHECK; Iteration++)
+				{
+					Tree.RunIteration(Root);
+				}
+			} while (FPlatformTime::Seconds() < Deadline);
+		});
+
+	// Walk the trees together, taking the action with the most visits over all of them
+	TArray<int32> Cursors;
+	Cursors.Init(0, NumTrees);
+
+	TArray<FTBSAction> MergedActions;
+	TArray<int32> MergedVisits;
+	TArray<float> MergedValues;
+
+	for (int32 Step = 0; Step < FTBSSearch::MAX_PLY; Step++)
+	{
+		MergedActions.Reset();
+		MergedVisits.Reset();
+		MergedValues.Reset();
+
+		for (int32 TreeIndex = 0; TreeIndex < NumTrees; TreeIndex++)
+		{
+			if (Cursors[TreeIndex] == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const FTBSMonteCarloTree& Tree = Trees[TreeIndex];
+			const FTBSMonteCarloTree::FNode& Node = Tree.GetNode(Cursors[TreeIndex]);
+			for (int32 EdgeIndex = Node.FirstEdge; EdgeIndex != INDEX_NONE && EdgeIndex < Node.FirstEdge + Node.NumEdges; EdgeIndex++)
+			{
+				const FTBSMonteCarloTree::FEdge& Edge = Tree.GetEdge(EdgeIndex);
+				int32 Slot = MergedActions.Find(Edge.Action);
+				if (Slot == INDEX_NONE)
+				{
+					Slot = MergedActions.Add(Edge.Action);
+					MergedVisits.Add(0);
+					MergedValues.Add(0.0f);
+				}
+				MergedVisits[Slot] += Edge.Visits;
+				MergedValues[Slot] += Edge.Value;
+			}
+		}
+
+		int32 BestSlot = INDEX_NONE;
+		for (int32 Slot = 0; Slot < MergedActions.Num(); Slot++)
+		{
+			if (MergedVisits[Slot] > 0 && (BestSlot == INDEX_NONE || MergedVisits[Slot] > MergedVisits[BestSlot]))
+			{
+				BestSlot = Slot;
+			}
+		}
+
+		if (BestSlot == INDEX_NONE)
+		{
+			break;
+		}
+
+		const FTBSAction BestAction = MergedActions[BestSlot];
+		OutResult.Plan.Add(BestAction);
+		if (Step == 0)
+		{
+			OutResult.Score = FMath::RoundToInt(MergedValues[BestSlot] / MergedVisits[BestSlot] * 1000.0f);
+		}
+
+		// The turn is over, or the rolls decide what comes next
+		if (BestAction.Type != ETBSActionType::Move)
+		{
+			break;
+		}
+
+		OutResult.Depth = Step + 1;
+
+		for (int32 TreeIndex = 0; TreeIndex < NumTrees; TreeIndex++)
+		{
+			if (Cursors[TreeIndex] == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const FTBSMonteCarloTree& Tree = Trees[TreeIndex];
+			const FTBSMonteCarloTree::FNode& Node = Tree.GetNode(Cursors[TreeIndex]);
+
+			int32 NextNode = INDEX_NONE;
+			for (int32 EdgeIndex = Node.FirstEdge; EdgeIndex != INDEX_NONE && EdgeIndex < Node.FirstEdge + Node.NumEdges; EdgeIndex++)
+			{
+				if (Tree.GetEdge(EdgeIndex).Action == BestAction)
+				{
+					NextNode = Tree.FindLikeliestOutcome(EdgeIndex);
+					break;
+				}
+			}
+			Cursors[TreeIndex] = NextNode;
+		}
+	}
+
+	if (OutResult.Plan.Num() == 0)
+	{
+		OutResult.Plan.Add(FTBSAction::MakeEndTurn());
+	}
+
+	for (const FTBSMonteCarloTree& Tree : Trees)
+	{
+		OutResult.NumNodes += Tree.GetNumIterations();
+	}
+	OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+}
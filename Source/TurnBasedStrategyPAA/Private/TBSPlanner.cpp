@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSPlanner.h"
+#include "TBSStats.h"
+
+template <typename ThinkType>
+void FTBSPlanner::StartTask(ThinkType&& Think)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Version++;
+	bHasResult = false;
+
+	// The task keeps the planner alive until it's done
+	TSharedRef<FTBSPlanner, ESPMode::ThreadSafe> Planner = AsShared();
+	SearchTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Planner, Think = Forward<ThinkType>(Think), SearchVersion = Version]()
+		{
+			FTBSSearchResult SearchResult;
+			{
+				TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_AISearch);
+				Think(*Planner, SearchResult);
+			}
+			TBS_COUNTER_ADD(TBS_SearchNodes, SearchResult.NumNodes);
+
+			FScopeLock PlannerLock(&Planner->Lock);
+			if (Planner->Version == SearchVersion)
+			{
+				Planner->Result = MoveTemp(SearchResult);
+				Planner->bHasResult = true;
+			}
+		},
+		UE::Tasks::Prerequisites(SearchTask));
+}
+
+void FTBSPlanner::Start(const FTBSGameState& State, const FTBSSearchSettings& Settings)
+{
+	// The task owns its copy of the match
+	StartTask([Root = State, Settings](FTBSPlanner& Planner, FTBSSearchResult& OutResult)
+		{
+			Planner.Search.Search(Root, Settings, OutResult);
+		});
+}
+
+void FTBSPlanner::Start(const FTBSGameState& State, const FTBSMonteCarloSettings& Settings)
+{
+	StartTask([Root = State, Settings](FTBSPlanner& Planner, FTBSSearchResult& OutResult)
+		{
+			Planner.MonteCarlo.Search(Root, Settings, OutResult);
+		});
+}
+
+bool FTBSPlanner::IsReady() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return bHasResult;
+}
+
+bool FTBSPlanner::TakeResult(FTBSSearchResult& OutResult)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (!bHasResult)
+	{
+		return false;
+	}
+
+	OutResult = MoveTemp(Result);
+	bHasResult = false;
+	return true;
+}
+
+void FTBSPlanner::Cancel()
+{
+	FScopeLock ScopeLock(&Lock);
+	Version++;
+	bHasResult = false;
+}
+
+void FTBSPlanner::Flush()
+{
+	UE::Tasks::FTask Task;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Task = SearchTask;
+	}
+	Task.Wait();
+}
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSRandom.h"
+
+// SplitMix64 finalizer, spreads nearby seeds over the whole state space
+static FORCEINLINE uint64 MixSeed(uint64 Value)
+{
+	Value += 0x9E3779B97F4A7C15ull;
+	Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+	return Value ^ (Value >> 31);
+}
+
+void FTBSRandom::Initialize(const uint64 Seed, const uint64 Stream)
+{
+	// Reference PCG32 seeding
+	State = 0;
+	Increment = (Stream << 1) | 1;
+	GetUInt32();
+	State += MixSeed(Seed);
+	GetUInt32();
+}
+
+void FTBSMatchRandom::Initialize(const int32 InSeed)
+{
+	Seed = InSeed;
+
+	// Streams get both their own increment and their own starting state, PCG streams that only
+	// differ by the increment are known to be correlated
+	for (int32 StreamIndex = 0; StreamIndex < NUM_STREAMS; StreamIndex++)
+	{
+		const uint64 StreamSeed = MixSeed(static_cast<uint64>(static_cast<uint32>(Seed)) ^ (static_cast<uint64>(StreamIndex + 1) << 32));
+		Streams[StreamIndex].Initialize(StreamSeed, static_cast<uint64>(StreamIndex));
+	}
+}
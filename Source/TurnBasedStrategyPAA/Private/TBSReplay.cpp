@@ -0,0 +1,178 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSReplay.h"
+
+FTBSReplay::FTBSReplay()
+	: Log(nullptr)
+	, Position(0)
+	, NextTurn(0)
+{
+}
+
+bool FTBSReplay::Start(const FTBSActionLog& InLog)
+{
+	Log = &InLog;
+	Position = 0;
+	NextTurn = 0;
+	Error.Reset();
+
+	for (int32 Player = 0; Player < FTBSGameState::NUM_PLAYERS; Player++)
+	{
+		for (int32 Type = 0; Type < NUM_UNIT_TYPES; Type++)
+		{
+			UnitIndices[Player][Type] = INDEX_NONE;
+		}
+	}
+
+	if (Log->GetGridSize() <= 0 || Log->GetGridSize() * Log->GetGridSize() > MAX_uint16 + 1)
+	{
+		return Fail(TEXT("invalid grid size"));
+	}
+
+	// Same map as the round that was logged
+	FMapGenerator::Generate(Log->GetMapSeed(), Log->GetGridSize(), Log->GetObstaclePercentage(), Layout);
+	State.Init(Log->GetGridSize());
+	Layout.Obstacles.ForEachSetBit([this](const int32 Index)
+		{
+			State.SetObstacle(Index);
+		});
+
+	if (BFS.GetSize() != Log->GetGridSize())
+	{
+		BFS.Init(Log->GetGridSize());
+	}
+
+	State.SetSideToMove(Log->GetStartingPlayer());
+	return true;
+}
+
+bool FTBSReplay::Step()
+{
+	if (IsFinished() || !Error.IsEmpty())
+	{
+		return false;
+	}
+
+	AdvanceTurns();
+
+	if (!PlayRecord(Log->GetRecord(Position)))
+	{
+		return false;
+	}
+
+	Position++;
+	return true;
+}
+
+bool FTBSReplay::Run()
+{
+	while (Step())
+	{
+	}
+
+	if (!Error.IsEmpty())
+	{
+		return false;
+	}
+
+	// A turn may have started after the last action
+	AdvanceTurns();
+	return true;
+}
+
+void FTBSReplay::AdvanceTurns()
+{
+	const TArray<int32>& TurnStarts = Log->GetTurnStarts();
+	while (NextTurn < TurnStarts.Num() && TurnStarts[NextTurn] <= Position && !State.IsGameOver())
+	{
+		FTBSUndo Undo;
+		if (NextTurn == 0)
+		{
+			// The coin toss winner plays first
+			State.SetSideToMove(Log->GetStartingPlayer());
+		}
+		else
+		{
+			State.MakeAction(FTBSAction::MakeEndTurn(), 0, 0, Undo);
+		}
+		NextTurn++;
+	}
+}
+
+bool FTBSReplay::PlayRecord(const FTBSLogRecord& Record)
+{
+	const int32 Type = static_cast<int32>(Record.Unit);
+	if (Record.Player >= FTBSGameState::NUM_PLAYERS || Type <= 0 || Type >= NUM_UNIT_TYPES)
+	{
+		return Fail(TEXT("unknown player or unit"));
+	}
+
+	int32& UnitIndex = UnitIndices[Record.Player][Type];
+
+	if (Record.Action == ETBSLogAction::Place)
+	{
+		if (UnitIndex != INDEX_NONE || Record.ToCell >= State.GetNumCells() || !State.IsWalkable(Record.ToCell))
+		{
+			return Fail(TEXT("placement on an occupied cell or of a unit already placed"));
+		}
+
+		UnitIndex = State.AddUnit(FTBSUnitState::MakeDefault(Record.Unit, Record.Player, Record.ToCell));
+		return (UnitIndex != INDEX_NONE) || Fail(TEXT("too many units"));
+	}
+
+	if (UnitIndex == INDEX_NONE || !State.GetUnit(UnitIndex).IsAlive())
+	{
+		return Fail(TEXT("the unit isn't on the board"));
+	}
+
+	if (Record.Action == ETBSLogAction::Skip)
+	{
+		return true;
+	}
+
+	if (Record.ToCell >= State.GetNumCells())
+	{
+		return Fail(TEXT("cell out of the board"));
+	}
+
+	FTBSAction Action;
+	if (Record.Action == ETBSLogAction::Move)
+	{
+		if (State.GetUnit(UnitIndex).Cell != Record.FromCell)
+		{
+			return Fail(TEXT("the unit isn't where the move starts"));
+		}
+		Action = FTBSAction::MakeMove(UnitIndex, Record.ToCell);
+	}
+	else
+	{
+		const int32 TargetIndex = State.GetCellContent(Record.ToCell);
+		if (TargetIndex < 0)
+		{
+			return Fail(TEXT("no unit on the attacked cell"));
+		}
+		if (State.HasCounterDamage(UnitIndex, TargetIndex) != (Record.CounterDamage > 0))
+		{
+			return Fail(TEXT("counter-damage doesn't follow the rules"));
+		}
+		Action = FTBSAction::MakeAttack(UnitIndex, TargetIndex);
+	}
+
+	// Also checks the side to move and the actions left to the unit
+	State.GenerateActions(BFS, LegalActions);
+	if (!LegalActions.Contains(Action))
+	{
+		return Fail(TEXT("illegal action"));
+	}
+
+	FTBSUndo Undo;
+	State.MakeAction(Action, Record.Damage, Record.CounterDamage, Undo);
+	return true;
+}
+
+bool FTBSReplay::Fail(const TCHAR* Reason)
+{
+	Error = FString::Printf(TEXT("Record %d: %s"), Position, Reason);
+	return false;
+}
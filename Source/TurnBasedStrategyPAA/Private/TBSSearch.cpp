@@ -0,0 +1,550 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSSearch.h"
+
+// Bound of every score, above any win
+static constexpr int32 INFINITE_SCORE = FTBSSearch::WIN_SCORE * 2;
+
+// Evaluation weights: a unit on the board is worth a lot more than a few health points
+static constexpr int32 UNIT_ALIVE_VALUE = 300;
+static constexpr int32 HEALTH_VALUE = 10;
+static constexpr int32 BRAWLER_DISTANCE_PENALTY = 3;
+static constexpr int32 SNIPER_IN_RANGE_BONUS = 30;
+static constexpr int32 SNIPER_CONTACT_PENALTY = 40;
+
+// Ordering bands: table action, previous best line, winning captures, other attacks, killers, moves, end of turn
+static constexpr int32 ORDER_TABLE_ACTION = 5000000;
+static constexpr int32 ORDER_PREVIOUS_LINE = 4000000;
+static constexpr int32 ORDER_KILL = 3000000;
+static constexpr int32 ORDER_ATTACK = 2000000;
+static constexpr int32 ORDER_KILLER = 1500000;
+static constexpr int32 ORDER_MOVE = 1000000;
+static constexpr int32 ORDER_END_TURN = 0;
+
+// Order of attacks within their band: sure kills before likely ones before the rest
+static constexpr float KILL_ODDS_ORDER = 1000.0f;
+
+// Nodes between two looks at the clock
+static constexpr int64 CLOCK_CHECK_MASK = 1023;
+
+// Empty killer slot, matches no legal action
+static const FTBSAction NO_ACTION = FTBSAction::MakeMove(INDEX_NONE, INDEX_NONE);
+
+// Win scores count plies from the root, the table keeps them from the stored position
+static FORCEINLINE int32 ScoreToTable(const int32 Score, const int32 Ply)
+{
+	if (Score >= FTBSSearch::WIN_SCORE - FTBSSearch::MAX_PLY)
+	{
+		return Score + Ply;
+	}
+	if (Score <= -(FTBSSearch::WIN_SCORE - FTBSSearch::MAX_PLY))
+	{
+		return Score - Ply;
+	}
+	return Score;
+}
+
+static FORCEINLINE int32 ScoreFromTable(const int32 Score, const int32 Ply)
+{
+	if (Score >= FTBSSearch::WIN_SCORE - FTBSSearch::MAX_PLY)
+	{
+		return Score - Ply;
+	}
+	if (Score <= -(FTBSSearch::WIN_SCORE - FTBSSearch::MAX_PLY))
+	{
+		return Score + Ply;
+	}
+	return Score;
+}
+
+FTBSSearch::FTBSSearch()
+	: Deadline(0.0)
+	, bAborted(false)
+	, NumNodes(0)
+	, CompletedDepth(0)
+{
+	FMemory::Memzero(PrincipalLength, sizeof(PrincipalLength));
+	FMemory::Memzero(FollowLine, sizeof(FollowLine));
+}
+
+void FTBSSearch::Search(const FTBSGameState& Root, const FTBSSearchSettings& InSettings, FTBSSearchResult& OutResult)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	Settings = InSettings;
+	Deadline = StartTime + Settings.TimeBudget;
+	NumNodes = 0;
+	CompletedDepth = 0;
+
+	State = Root;
+	if (BFS.GetSize() != State.GetSize())
+	{
+		BFS.Init(State.GetSize());
+	}
+
+	if (Table.GetSizeMB() != Settings.TableSizeMB)
+	{
+		Table.Resize(Settings.TableSizeMB);
+	}
+	Table.NewSearch();
+
+	for (int32 Ply = 0; Ply < MAX_PLY; Ply++)
+	{
+		Killers[Ply][0] = Killers[Ply][1] = NO_ACTION;
+		TableActions[Ply] = NO_ACTION;
+	}
+
+	PreviousLine.Reset();
+	OutResult = FTBSSearchResult();
+
+	if (State.IsGameOver())
+	{
+		return;
+	}
+
+	const int32 MaxDepth = FMath::Clamp(Settings.MaxDepth, 1, MAX_PLY - 1);
+	for (int32 Depth = 1; Depth <= MaxDepth; Depth++)
+	{
+		bAborted = false;
+		FollowLine[0] = true;
+
+		const int32 Score = AlphaBeta(Depth, 0, -INFINITE_SCORE, INFINITE_SCORE);
+		if (bAborted)
+		{
+			break;
+		}
+
+		CompletedDepth = Depth;
+		OutResult.Score = Score;
+		OutResult.Depth = Depth;
+
+		PreviousLine.Reset();
+		PreviousLine.Append(&PrincipalVariation[0][0], PrincipalLength[0]);
+		ExtendLineFromTable(Depth);
+
+		// A forced result doesn't get better with depth
+		if (FMath::Abs(Score) >= WIN_SCORE - MAX_PLY)
+		{
+			break;
+		}
+
+		// The next iteration costs several times this one, don't start what can't finish
+		const bool bHalfSpent = (Settings.MaxNodes > 0) ?
+			NumNodes > Settings.MaxNodes / 2 :
+			FPlatformTime::Seconds() - StartTime > Settings.TimeBudget * 0.5f;
+		if (bHalfSpent)
+		{
+			break;
+		}
+	}
+
+	// Keep the actions of the current turn
+	for (const FTBSAction& Action : PreviousLine)
+	{
+		OutResult.Plan.Add(Action);
+		if (Action.Type == ETBSActionType::EndTurn)
+		{
+			break;
+		}
+	}
+
+	if (OutResult.Plan.Num() == 0)
+	{
+		OutResult.Plan.Add(FTBSAction::MakeEndTurn());
+	}
+
+	OutResult.NumNodes = NumNodes;
+	OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+}
+
+int32 FTBSSearch::Evaluate(const FTBSGameState& State, const int32 Side)
+{
+	int32 Score = 0;
+
+	for (int32 UnitIndex = 0; UnitIndex < State.GetNumUnits(); UnitIndex++)
+	{
+		const FTBSUnitState& Unit = State.GetUnit(UnitIndex);
+		if (!Unit.IsAlive())
+		{
+			continue;
+		}
+
+		int32 Value = UNIT_ALIVE_VALUE + Unit.Health * HEALTH_VALUE;
+
+		// Distance to the closest enemy, and whether an enemy Brawler is right next to us
+		int32 MinDistance = MAX_int32;
+		bool bBrawlerContact = false;
+		for (int32 EnemyIndex = 0; EnemyIndex < State.GetNumUnits(); EnemyIndex++)
+		{
+			const FTBSUnitState& Enemy = State.GetUnit(EnemyIndex);
+			if (!Enemy.IsAlive() || Enemy.Owner == Unit.Owner)
+			{
+				continue;
+			}
+
+			const int32 Distance = State.GetCellDistance(Unit.Cell, Enemy.Cell);
+			MinDistance = FMath::Min(MinDistance, Distance);
+			bBrawlerContact |= (Enemy.Type == EUnitType::BRAWLER && Distance <= 1);
+		}
+
+		if (MinDistance != MAX_int32)
+		{
+			if (Unit.Type == EUnitType::BRAWLER)
+			{
+				// Brawlers only hurt what they touch
+				Value -= MinDistance * BRAWLER_DISTANCE_PENALTY;
+			}
+			else
+			{
+				// Snipers want a target in range, without a Brawler in their face
+				if (MinDistance <= Unit.AttackRange)
+				{
+					Value += SNIPER_IN_RANGE_BONUS;
+				}
+				if (bBrawlerContact)
+				{
+					Value -= SNIPER_CONTACT_PENALTY;
+				}
+			}
+		}
+
+		Score += (Unit.Owner == Side) ? Value : -Value;
+	}
+
+	return Score;
+}
+
+int32 FTBSSearch::AlphaBeta(const int32 Depth, const int32 Ply, int32 Alpha, const int32 Beta)
+{
+	NumNodes++;
+	PrincipalLength[Ply] = Ply;
+
+	const int32 Side = State.GetSideToMove();
+
+	if (State.IsGameOver())
+	{
+		const int32 Winner = State.GetWinner();
+		if (Winner == FTBSGameState::DRAW)
+		{
+			return 0;
+		}
+
+		// Win sooner, lose later
+		return (Winner == Side) ? WIN_SCORE - Ply : -(WIN_SCORE - Ply);
+	}
+
+	if (Depth <= 0 || Ply >= MAX_PLY - 1)
+	{
+		return Evaluate(State, Side);
+	}
+
+	if (IsOutOfTime())
+	{
+		return 0;
+	}
+
+	// The root is always searched, so there is a line to play
+	FTBSTableEntry Entry;
+	const bool bTableHit = Table.Probe(State.GetKey(), Entry);
+	if (bTableHit && Ply > 0 && Entry.Depth >= Depth)
+	{
+		const int32 TableScore = ScoreFromTable(Entry.Score, Ply);
+		if (Entry.Bound == ETBSBound::Exact ||
+			(Entry.Bound == ETBSBound::Lower && TableScore >= Beta) ||
+			(Entry.Bound == ETBSBound::Upper && TableScore <= Alpha))
+		{
+			return TableScore;
+		}
+	}
+	TableActions[Ply] = (bTableHit && Entry.bHasAction) ? Entry.Action : NO_ACTION;
+
+	GenerateOrderedActions(Ply);
+
+	TArray<FTBSAction>& NodeActions = Actions[Ply];
+	TArray<int32>& NodeScores = ActionScores[Ply];
+
+	const int32 OriginalAlpha = Alpha;
+	int32 BestScore = -INFINITE_SCORE;
+	FTBSAction BestAction = NO_ACTION;
+
+	for (int32 Slot = 0; Slot < NodeActions.Num(); Slot++)
+	{
+		// Pick the best remaining action, a cutoff often comes before the list is sorted
+		int32 BestSlot = Slot;
+		for (int32 Other = Slot + 1; Other < NodeActions.Num(); Other++)
+		{
+			if (NodeScores[Other] > NodeScores[BestSlot])
+			{
+				BestSlot = Other;
+			}
+		}
+		if (BestSlot != Slot)
+		{
+			Swap(NodeActions[Slot], NodeActions[BestSlot]);
+			Swap(NodeScores[Slot], NodeScores[BestSlot]);
+		}
+
+		const FTBSAction Action = NodeActions[Slot];
+		FollowLine[Ply + 1] = FollowLine[Ply] && PreviousLine.IsValidIndex(Ply) && PreviousLine[Ply] == Action;
+
+		FTBSUndo Undo;
+		State.MakeExpectedAction(Action, Undo);
+
+		// Same player: same window, other player: negamax
+		int32 Score;
+		if (State.GetSideToMove() == Side)
+		{
+			Score = AlphaBeta(Depth - 1, Ply + 1, Alpha, Beta);
+		}
+		else
+		{
+			Score = -AlphaBeta(Depth - 1, Ply + 1, -Beta, -Alpha);
+		}
+
+		State.UnmakeAction(Undo);
+
+		if (bAborted)
+		{
+			return 0;
+		}
+
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestAction = Action;
+
+			// Extend the line of the child with this action
+			PrincipalVariation[Ply][Ply] = Action;
+			for (int32 Next = Ply + 1; Next < PrincipalLength[Ply + 1]; Next++)
+			{
+				PrincipalVariation[Ply][Next] = PrincipalVariation[Ply + 1][Next];
+			}
+			PrincipalLength[Ply] = FMath::Max(PrincipalLength[Ply + 1], Ply + 1);
+
+			if (Score > Alpha)
+			{
+				Alpha = Score;
+			}
+
+			if (Alpha >= Beta)
+			{
+				// Remember quiet actions that refuted this node, they're often good in the siblings too
+				if (Action.Type != ETBSActionType::Attack && !(Killers[Ply][0] == Action))
+				{
+					Killers[Ply][1] = Killers[Ply][0];
+					Killers[Ply][0] = Action;
+				}
+				break;
+			}
+		}
+	}
+
+	const ETBSBound Bound = (BestScore <= OriginalAlpha) ? ETBSBound::Upper : (BestScore >= Beta) ? ETBSBound::Lower : ETBSBound::Exact;
+	Table.Store(State.GetKey(), ScoreToTable(BestScore, Ply), Depth, Bound, BestAction);
+
+	return BestScore;
+}
+
+void FTBSSearch::GenerateOrderedActions(const int32 Ply)
+{
+	TArray<FTBSAction>& NodeActions = Actions[Ply];
+	TArray<int32>& NodeScores = ActionScores[Ply];
+	NodeActions.Reset();
+	NodeScores.Reset();
+
+	const int32 Side = State.GetSideToMove();
+
+	// The root keeps every destination, deeper nodes only the most promising ones
+	const int32 MaxMoves = (Ply == 0) ? MAX_int32 : FMath::Max(1, Settings.MaxMovesPerUnit);
+
+	for (int32 UnitIndex = 0; UnitIndex < State.GetNumUnits(); UnitIndex++)
+	{
+		const FTBSUnitState& Unit = State.GetUnit(UnitIndex);
+		if (Unit.Owner != Side || !Unit.IsAlive())
+		{
+			continue;
+		}
+
+		// Attacks, killing blows first, then the likeliest kills and the weakest targets
+		if (!Unit.bAttacked)
+		{
+			const int32 Damage = FTBSGameState::GetExpectedDamage(Unit);
+			const bool bTabulated = FTBSCombatTables::IsTabulated(Unit.Type, Unit.MinDamage, Unit.MaxDamage);
+			for (int32 TargetIndex = 0; TargetIndex < State.GetNumUnits(); TargetIndex++)
+			{
+				if (!State.CanAttack(UnitIndex, TargetIndex))
+				{
+					continue;
+				}
+
+				const FTBSUnitState& Target = State.GetUnit(TargetIndex);
+				int32 Score = (Damage >= Target.Health) ? ORDER_KILL : ORDER_ATTACK;
+				Score -= Target.Health * HEALTH_VALUE;
+				if (bTabulated)
+				{
+					Score += FMath::RoundToInt(FTBSCombatTables::GetKillProbability(Unit.Type, Target.Health) * KILL_ODDS_ORDER);
+				}
+				if (State.HasCounterDamage(UnitIndex, TargetIndex))
+				{
+					Score -= FMath::RoundToInt(FTBSCombatTables::GetExpectedCounterDamage(Unit.Health) * HEALTH_VALUE);
+					Score -= FMath::RoundToInt(FTBSCombatTables::GetCounterKillProbability(Unit.Health) * KILL_ODDS_ORDER);
+				}
+
+				NodeActions.Add(FTBSAction::MakeAttack(UnitIndex, TargetIndex));
+				NodeScores.Add(Score);
+			}
+		}
+
+		// Moves, best destinations first
+		State.FindMoveCells(UnitIndex, BFS, MoveCells);
+		if (MoveCells.Num() == 0)
+		{
+			continue;
+		}
+
+		MoveScores.Reset();
+		MoveOrder.Reset();
+		for (int32 Slot = 0; Slot < MoveCells.Num(); Slot++)
+		{
+			MoveScores.Add(ScoreMoveCell(State, UnitIndex, MoveCells[Slot]));
+			MoveOrder.Add(Slot);
+		}
+
+		const int32 NumKept = FMath::Min(MaxMoves, MoveCells.Num());
+		if (NumKept < MoveCells.Num())
+		{
+			MoveOrder.Sort([this](const int32 A, const int32 B)
+				{
+					return MoveScores[A] > MoveScores[B];
+				});
+		}
+
+		for (int32 Kept = 0; Kept < NumKept; Kept++)
+		{
+			const int32 Slot = MoveOrder[Kept];
+			NodeActions.Add(FTBSAction::MakeMove(UnitIndex, MoveCells[Slot]));
+			NodeScores.Add(ORDER_MOVE + MoveScores[Slot]);
+		}
+	}
+
+	NodeActions.Add(FTBSAction::MakeEndTurn());
+	NodeScores.Add(ORDER_END_TURN);
+
+	// The table's action, the line of the previous iteration and the killers jump the queue
+	for (int32 Slot = 0; Slot < NodeActions.Num(); Slot++)
+	{
+		const FTBSAction& Action = NodeActions[Slot];
+		if (TableActions[Ply] == Action)
+		{
+			NodeScores[Slot] = ORDER_TABLE_ACTION;
+		}
+		else if (FollowLine[Ply] && PreviousLine.IsValidIndex(Ply) && PreviousLine[Ply] == Action)
+		{
+			NodeScores[Slot] = ORDER_PREVIOUS_LINE;
+		}
+		else if (Action.Type != ETBSActionType::Attack && (Killers[Ply][0] == Action || Killers[Ply][1] == Action))
+		{
+			NodeScores[Slot] = FMath::Max(NodeScores[Slot], ORDER_KILLER);
+		}
+	}
+}
+
+int32 FTBSSearch::ScoreMoveCell(const FTBSGameState& State, const int32 UnitIndex, const int32 Cell)
+{
+	const FTBSUnitState& Unit = State.GetUnit(UnitIndex);
+
+	int32 Score = 0;
+	int32 MinDistance = MAX_int32;
+
+	for (int32 EnemyIndex = 0; EnemyIndex < State.GetNumUnits(); EnemyIndex++)
+	{
+		const FTBSUnitState& Enemy = State.GetUnit(EnemyIndex);
+		if (!Enemy.IsAlive() || Enemy.Owner == Unit.Owner)
+		{
+			continue;
+		}
+
+		const int32 Distance = State.GetCellDistance(Cell, Enemy.Cell);
+		MinDistance = FMath::Min(MinDistance, Distance);
+
+		// Being able to attack from there is what matters most
+		if (!Unit.bAttacked && Distance <= Unit.AttackRange)
+		{
+			Score += 100;
+		}
+
+		// Snipers stay out of the reach of enemy Brawlers
+		if (Unit.Type == EUnitType::SNIPER && Enemy.Type == EUnitType::BRAWLER && Distance <= Enemy.MovementRange + Enemy.AttackRange)
+		{
+			Score -= 20;
+		}
+	}
+
+	if (MinDistance == MAX_int32)
+	{
+		return Score;
+	}
+
+	if (Unit.Type == EUnitType::BRAWLER)
+	{
+		Score -= MinDistance * 4;
+	}
+	else
+	{
+		Score -= FMath::Max(0, MinDistance - Unit.AttackRange) * 4;
+		if (MinDistance <= 1)
+		{
+			Score -= 30;
+		}
+	}
+
+	return Score;
+}
+
+bool FTBSSearch::IsOutOfTime()
+{
+	// The first iteration always completes, so there is always a plan
+	if (bAborted || CompletedDepth == 0)
+	{
+		return bAborted;
+	}
+
+	if (Settings.MaxNodes > 0)
+	{
+		bAborted = (NumNodes >= Settings.MaxNodes);
+	}
+	else if ((NumNodes & CLOCK_CHECK_MASK) == 0 && FPlatformTime::Seconds() >= Deadline)
+	{
+		bAborted = true;
+	}
+	return bAborted;
+}
+
+void FTBSSearch::ExtendLineFromTable(const int32 Depth)
+{
+	LineUndos.Reset();
+	for (const FTBSAction& Action : PreviousLine)
+	{
+		State.MakeExpectedAction(Action, LineUndos.AddDefaulted_GetRef());
+	}
+
+	FTBSTableEntry Entry;
+	while (PreviousLine.Num() < Depth && !State.IsGameOver() && Table.Probe(State.GetKey(), Entry) && Entry.bHasAction)
+	{
+		// Keys can collide, only follow actions that are legal here
+		State.GenerateActions(BFS, LegalActions);
+		if (!LegalActions.Contains(Entry.Action))
+		{
+			break;
+		}
+
+		PreviousLine.Add(Entry.Action);
+		State.MakeExpectedAction(Entry.Action, LineUndos.AddDefaulted_GetRef());
+	}
+
+	for (int32 Index = LineUndos.Num() - 1; Index >= 0; Index--)
+	{
+		State.UnmakeAction(LineUndos[Index]);
+	}
+}
@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSSimulateCommandlet.h"
+#include "TBSReplay.h"
+
+UTBSSimulateCommandlet::UTBSSimulateCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTBSSimulateCommandlet::Main(const FString& Params)
+{
+	FString ReplayFile;
+	if (FParse::Value(*Params, TEXT("Replay="), ReplayFile))
+	{
+		return RunReplay(ReplayFile);
+	}
+
+	int32 NumMatches = 100;
+	FParse::Value(*Params, TEXT("Matches="), NumMatches);
+	NumMatches = FMath::Max(1, NumMatches);
+
+	FTBSMatchSettings Settings;
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("Size="), Settings.GridSize);
+	FParse::Value(*Params, TEXT("Obstacles="), Settings.ObstaclePercentage);
+	FParse::Value(*Params, TEXT("MaxTurns="), Settings.MaxTurns);
+
+	// Node and iteration budgets keep the matches reproducible, -Think= trades that for time budgets
+	float ThinkTime = 0.0f;
+	int32 Depth = 0;
+	int32 MaxNodes = 20000;
+	int32 MaxIterations = 500;
+	FParse::Value(*Params, TEXT("Think="), ThinkTime);
+	FParse::Value(*Params, TEXT("Depth="), Depth);
+	FParse::Value(*Params, TEXT("Nodes="), MaxNodes);
+	FParse::Value(*Params, TEXT("Iterations="), MaxIterations);
+	const bool bTimed = (ThinkTime > 0.0f);
+
+	Settings.Players[0].Agent = ETBSSimAgent::AlphaBeta;
+	Settings.Players[1].Agent = ETBSSimAgent::Random;
+	if (!ParseAgent(Params, TEXT("P0="), Settings.Players[0].Agent) || !ParseAgent(Params, TEXT("P1="), Settings.Players[1].Agent))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Unknown agent, use Random, AlphaBeta or MonteCarlo"));
+		return 1;
+	}
+
+	for (FTBSSimPlayer& Player : Settings.Players)
+	{
+		// A fixed depth replaces both limits
+		Player.Search.TimeBudget = (Depth > 0 || !bTimed) ? 1000.0f : ThinkTime;
+		Player.Search.MaxNodes = (Depth > 0 || bTimed) ? 0 : FMath::Max(1, MaxNodes);
+		Player.Search.MaxDepth = (Depth > 0) ? Depth : Player.Search.MaxDepth;
+		Player.MonteCarlo.TimeBudget = bTimed ? ThinkTime : 1000.0f;
+		Player.MonteCarlo.MaxIterations = bTimed ? 0 : FMath::Max(1, MaxIterations);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Simulating %d matches: %s (P0) vs %s (P1), %dx%d, %.0f%% obstacles, seeds %d+"),
+		NumMatches, GetAgentName(Settings.Players[0].Agent), GetAgentName(Settings.Players[1].Agent),
+		Settings.GridSize, Settings.GridSize, Settings.ObstaclePercentage, Settings.Seed);
+
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<FTBSMatchResult> Results;
+	FTBSMatchSimulator::PlayBatch(Settings, NumMatches, Results);
+	const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int32 Wins[FTBSGameState::NUM_PLAYERS] = {};
+	int32 Draws = 0;
+	int32 TurnLimits = 0;
+	int32 StarterWins = 0;
+	int64 NumTurns = 0;
+	int64 NumActions = 0;
+	int64 PlayerTurns[FTBSGameState::NUM_PLAYERS] = {};
+	double ThinkSeconds[FTBSGameState::NUM_PLAYERS] = {};
+	double MatchSeconds = 0.0;
+
+	for (const FTBSMatchResult& Result : Results)
+	{
+		if (Result.Winner == FTBSGameState::DRAW)
+		{
+			Draws++;
+			TurnLimits += Result.bTurnLimit ? 1 : 0;
+		}
+		else
+		{
+			Wins[Result.Winner]++;
+			StarterWins += (Result.Winner == Result.StartingPlayer) ? 1 : 0;
+		}
+
+		NumTurns += Result.NumTurns;
+		NumActions += Result.NumActions;
+		MatchSeconds += Result.Seconds;
+
+		// The starting player plays the odd turns
+		for (int32 Player = 0; Player < FTBSGameState::NUM_PLAYERS; Player++)
+		{
+			const bool bStarter = (Player == Result.StartingPlayer);
+			PlayerTurns[Player] += bStarter ? (Result.NumTurns + 1) / 2 : Result.NumTurns / 2;
+			ThinkSeconds[Player] += Result.ThinkSeconds[Player];
+		}
+	}
+
+	const int32 Decided = Wins[0] + Wins[1];
+	UE_LOG(LogTemp, Display, TEXT("P0 %s: %d wins (%.1f%%)"), GetAgentName(Settings.Players[0].Agent), Wins[0], 100.0 * Wins[0] / NumMatches);
+	UE_LOG(LogTemp, Display, TEXT("P1 %s: %d wins (%.1f%%)"), GetAgentName(Settings.Players[1].Agent), Wins[1], 100.0 * Wins[1] / NumMatches);
+	UE_LOG(LogTemp, Display, TEXT("Draws: %d (%d at the turn limit)"), Draws, TurnLimits);
+	UE_LOG(LogTemp, Display, TEXT("Coin toss winner won %.1f%% of the decided matches"), Decided > 0 ? 100.0 * StarterWins / Decided : 0.0);
+	UE_LOG(LogTemp, Display, TEXT("Average match: %.1f turns, %.1f actions, %.3f s"),
+		static_cast<double>(NumTurns) / NumMatches, static_cast<double>(NumActions) / NumMatches, MatchSeconds / NumMatches);
+	for (int32 Player = 0; Player < FTBSGameState::NUM_PLAYERS; Player++)
+	{
+		UE_LOG(LogTemp, Display, TEXT("P%d thinking: %.2f ms per turn"), Player, PlayerTurns[Player] > 0 ? 1000.0 * ThinkSeconds[Player] / PlayerTurns[Player] : 0.0);
+	}
+	UE_LOG(LogTemp, Display, TEXT("%.1f s wall time, %.0f matches per minute"), WallSeconds, WallSeconds > 0.0 ? 60.0 * NumMatches / WallSeconds : 0.0);
+
+	return 0;
+}
+
+int32 UTBSSimulateCommandlet::RunReplay(const FString& FileName)
+{
+	FTBSActionLog Log;
+	if (!Log.LoadFromFile(FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not read the action log %s"), *FileName);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Replaying %s: match seed %d, map seed %d, %dx%d, %d actions"),
+		*FileName, Log.GetMatchSeed(), Log.GetMapSeed(), Log.GetGridSize(), Log.GetGridSize(), Log.Num());
+
+	FTBSReplay Replay;
+	if (!Replay.Start(Log) || !Replay.Run())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay stopped: %s"), *Replay.GetError());
+		if (Replay.GetPosition() < Log.Num())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Offending action: %s"), *Log.FormatRecord(Replay.GetPosition()));
+		}
+		return 1;
+	}
+
+	const FTBSGameState& State = Replay.GetState();
+	const int32 Winner = State.GetWinner();
+	UE_LOG(LogTemp, Display, TEXT("Replay complete, %s"), Winner == INDEX_NONE ? TEXT("round unfinished") :
+		Winner == FTBSGameState::DRAW ? TEXT("draw") : (Winner == 0 ? TEXT("P0 won") : TEXT("P1 won")));
+	for (int32 UnitIndex = 0; UnitIndex < State.GetNumUnits(); UnitIndex++)
+	{
+		const FTBSUnitState& Unit = State.GetUnit(UnitIndex);
+		UE_LOG(LogTemp, Display, TEXT("P%d %s: %d/%d health"), Unit.Owner,
+			Unit.Type == EUnitType::BRAWLER ? TEXT("Brawler") : TEXT("Sniper"), Unit.Health, Unit.MaxHealth);
+	}
+	return 0;
+}
+
+bool UTBSSimulateCommandlet::ParseAgent(const FString& Params, const TCHAR* Key, ETBSSimAgent& OutAgent)
+{
+	FString Name;
+	if (!FParse::Value(*Params, Key, Name))
+	{
+		return true;
+	}
+
+	if (Name == TEXT("Random") || Name == TEXT("Naive"))
+	{
+		OutAgent = ETBSSimAgent::Random;
+	}
+	else if (Name == TEXT("AlphaBeta") || Name == TEXT("Smart"))
+	{
+		OutAgent = ETBSSimAgent::AlphaBeta;
+	}
+	else if (Name == TEXT("MonteCarlo") || Name == TEXT("MCTS"))
+	{
+		OutAgent = ETBSSimAgent::MonteCarlo;
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+const TCHAR* UTBSSimulateCommandlet::GetAgentName(const ETBSSimAgent Agent)
+{
+	switch (Agent)
+	{
+	case ETBSSimAgent::Random:
+		return TEXT("Random");
+	case ETBSSimAgent::AlphaBeta:
+		return TEXT("AlphaBeta");
+	case ETBSSimAgent::MonteCarlo:
+		return TEXT("MonteCarlo");
+	}
+	return TEXT("Unknown");
+}
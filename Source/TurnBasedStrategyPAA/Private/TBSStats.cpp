@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(TBSChannel);
+
+DEFINE_STAT(STAT_TBS_MovementTiles);
+DEFINE_STAT(STAT_TBS_AttackTiles);
+DEFINE_STAT(STAT_TBS_ValidateConnectivity);
+DEFINE_STAT(STAT_TBS_HighlightUpdate);
+
+DEFINE_STAT(STAT_TBS_SpawnObstacles);
+DEFINE_STAT(STAT_TBS_PlaceUnit);
+DEFINE_STAT(STAT_TBS_EndTurn);
+
+DEFINE_STAT(STAT_TBS_AIUnitAction);
+DEFINE_STAT(STAT_TBS_AIPlanCapture);
+DEFINE_STAT(STAT_TBS_AISearch);
+
+DEFINE_STAT(STAT_TBS_HistoryFormatting);
+
+DEFINE_STAT(STAT_TBS_BFSNodes);
+DEFINE_STAT(STAT_TBS_SearchNodes);
+DEFINE_STAT(STAT_TBS_TilesTouched);
+DEFINE_STAT(STAT_TBS_TileListsBuilt);
+
+TRACE_DECLARE_INT_COUNTER(TBS_BFSNodes, TEXT("TBS/BFS Nodes Expanded"));
+TRACE_DECLARE_INT_COUNTER(TBS_SearchNodes, TEXT("TBS/Search Nodes"));
+TRACE_DECLARE_INT_COUNTER(TBS_TilesTouched, TEXT("TBS/Tiles Touched"));
+TRACE_DECLARE_INT_COUNTER(TBS_TileListsBuilt, TEXT("TBS/Tile Lists Built"));
@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBSTranspositionTable.h"
+
+// Entry layout in 64 bits: score 24, depth 6, bound 2, generation 8, action type 2, unit 4, target 4, cell 14
+static constexpr int32 SCORE_BITS = 24;
+static constexpr int32 DEPTH_SHIFT = 24;
+static constexpr int32 BOUND_SHIFT = 30;
+static constexpr int32 GENERATION_SHIFT = 32;
+static constexpr int32 TYPE_SHIFT = 40;
+static constexpr int32 UNIT_SHIFT = 42;
+static constexpr int32 TARGET_SHIFT = 46;
+static constexpr int32 CELL_SHIFT = 50;
+
+static constexpr int32 SCORE_OFFSET = 1 << (SCORE_BITS - 1);
+static constexpr uint64 SCORE_MASK = (1ull << SCORE_BITS) - 1;
+static constexpr int32 MAX_STORED_DEPTH = 63;
+static constexpr int32 MAX_STORED_CELL = (1 << 14) - 1;
+
+// Action type field of an entry without action
+static constexpr uint64 NO_ACTION_TYPE = 3;
+
+static_assert(FTBSGameState::MAX_UNITS <= 16, "Unit indices are stored in 4 bits");
+
+FTBSTranspositionTable::FTBSTranspositionTable()
+	: BucketMask(0)
+	, SizeMB(0)
+	, Generation(0)
+{
+}
+
+void FTBSTranspositionTable::Resize(const int32 InSizeMB)
+{
+	const uint64 BucketSize = sizeof(FSlot) * 2;
+	const uint64 MaxBuckets = FMath::Max<uint64>(1, (static_cast<uint64>(FMath::Max(1, InSizeMB)) << 20) / BucketSize);
+
+	uint64 NumBuckets = 1;
+	while (NumBuckets * 2 <= MaxBuckets)
+	{
+		NumBuckets *= 2;
+	}
+
+	Slots = MakeUnique<FSlot[]>(NumBuckets * 2);
+	BucketMask = NumBuckets - 1;
+	SizeMB = InSizeMB;
+	Generation = 0;
+}
+
+void FTBSTranspositionTable::Clear()
+{
+	if (!Slots.IsValid())
+	{
+		return;
+	}
+
+	for (uint64 Index = 0; Index <= BucketMask * 2 + 1; Index++)
+	{
+		Slots[Index].Check.store(0, std::memory_order_relaxed);
+		Slots[Index].Data.store(0, std::memory_order_relaxed);
+	}
+}
+
+void FTBSTranspositionTable::NewSearch()
+{
+	Generation++;
+}
+
+bool FTBSTranspositionTable::Probe(const uint64 Key, FTBSTableEntry& OutEntry) const
+{
+	if (!Slots.IsValid())
+	{
+		return false;
+	}
+
+	const FSlot* Bucket = &Slots[(Key & BucketMask) * 2];
+	for (int32 Way = 0; Way < 2; Way++)
+	{
+		const uint64 Data = Bucket[Way].Data.load(std::memory_order_relaxed);
+		const uint64 Check = Bucket[Way].Check.load(std::memory_order_relaxed);
+		if ((Check ^ Data) == Key && Data != 0)
+		{
+			UnpackEntry(Data, OutEntry);
+			return OutEntry.Bound != ETBSBound::None;
+		}
+	}
+
+	return false;
+}
+
+void FTBSTranspositionTable::Store(const uint64 Key, const int32 Score, const int32 Depth, const ETBSBound Bound, const FTBSAction& Action)
+{
+	if (!Slots.IsValid())
+	{
+		return;
+	}
+
+	FSlot* Bucket = &Slots[(Key & BucketMask) * 2];
+
+	// The first slot is only given up for the same position, a result of an earlier search, or a deeper one
+	const uint64 StoredData = Bucket[0].Data.load(std::memory_order_relaxed);
+	const uint64 StoredKey = Bucket[0].Check.load(std::memory_order_relaxed) ^ StoredData;
+	const int32 StoredDepth = (StoredData >> DEPTH_SHIFT) & MAX_STORED_DEPTH;
+	const uint8 StoredGeneration = static_cast<uint8>(StoredData >> GENERATION_SHIFT);
+
+	FSlot& Slot = (StoredData == 0 || StoredKey == Key || StoredGeneration != Generation || Depth >= StoredDepth) ? Bucket[0] : Bucket[1];
+
+	const uint64 Data = PackEntry(Score, Depth, Bound, Generation, Action);
+	Slot.Check.store(Key ^ Data, std::memory_order_relaxed);
+	Slot.Data.store(Data, std::memory_order_relaxed);
+}
+
+uint64 FTBSTranspositionTable::PackEntry(const int32 Score, const int32 Depth, const ETBSBound Bound, const uint8 InGeneration, const FTBSAction& Action)
+{
+	uint64 Data = static_cast<uint64>(FMath::Clamp(Score + SCORE_OFFSET, 0, static_cast<int32>(SCORE_MASK))) & SCORE_MASK;
+	Data |= static_cast<uint64>(FMath::Clamp(Depth, 0, MAX_STORED_DEPTH)) << DEPTH_SHIFT;
+	Data |= static_cast<uint64>(Bound) << BOUND_SHIFT;
+	Data |= static_cast<uint64>(InGeneration) << GENERATION_SHIFT;
+
+	// Moves to cells past the field are left out, only a board over 128x128 has them
+	if (Action.Type == ETBSActionType::Move && (Action.Cell < 0 || Action.Cell > MAX_STORED_CELL))
+	{
+		return Data | (NO_ACTION_TYPE << TYPE_SHIFT);
+	}
+
+	Data |= static_cast<uint64>(Action.Type) << TYPE_SHIFT;
+	Data |= static_cast<uint64>(Action.Unit & 15) << UNIT_SHIFT;
+	Data |= static_cast<uint64>(Action.Target & 15) << TARGET_SHIFT;
+	Data |= static_cast<uint64>(Action.Type == ETBSActionType::Move ? Action.Cell : 0) << CELL_SHIFT;
+	return Data;
+}
+
+void FTBSTranspositionTable::UnpackEntry(const uint64 Data, FTBSTableEntry& OutEntry)
+{
+	OutEntry.Score = static_cast<int32>(Data & SCORE_MASK) - SCORE_OFFSET;
+	OutEntry.Depth = (Data >> DEPTH_SHIFT) & MAX_STORED_DEPTH;
+	OutEntry.Bound = static_cast<ETBSBound>((Data >> BOUND_SHIFT) & 3);
+
+	const uint64 Type = (Data >> TYPE_SHIFT) & 3;
+	const int32 Unit = (Data >> UNIT_SHIFT) & 15;
+	const int32 Target = (Data >> TARGET_SHIFT) & 15;
+	const int32 Cell = (Data >> CELL_SHIFT) & MAX_STORED_CELL;
+
+	OutEntry.bHasAction = (Type != NO_ACTION_TYPE);
+	switch (static_cast<ETBSActionType>(Type))
+	{
+	case ETBSActionType::Move:
+		OutEntry.Action = FTBSAction::MakeMove(Unit, Cell);
+		break;
+
+	case ETBSActionType::Attack:
+		OutEntry.Action = FTBSAction::MakeAttack(Unit, Target);
+		break;
+
+	default:
+		OutEntry.Action = FTBSAction::MakeEndTurn();
+		break;
+	}
+}
@@ -1,18 +1,21 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "TBS_GameInstance.h"
+#include "TBSStats.h"
 
 // Score Functions
 void UTBS_GameInstance::IncrementScoreHumanPlayer()
 {
     ScoreHumanPlayer++;
     TotalGamesPlayed++;
+    BroadcastScores();
 }
 
 void UTBS_GameInstance::IncrementScoreAiPlayer()
 {
     ScoreAIPlayer++;
     TotalGamesPlayed++;
+    BroadcastScores();
 }
 
 int32 UTBS_GameInstance::GetScoreHumanPlayer() const
@@ -29,6 +32,7 @@ int32 UTBS_GameInstance::GetScoreAiPlayer() const
 void UTBS_GameInstance::IncrementRound()
 {
     CurrentRound++;
+    OnRoundChanged.Broadcast(CurrentRound);
 }
 
 int32 UTBS_GameInstance::GetCurrentRound() const
@@ -44,85 +48,46 @@ FString UTBS_GameInstance::GetTurnMessage() const
 
 void UTBS_GameInstance::SetStartingPlayerMessage(int32 PlayerIndex)
 {
-    TurnMessage = (PlayerIndex == 0) ?
+    SetTurnMessage((PlayerIndex == 0) ?
         TEXT("Human Player starts the game") :
-        TEXT("AI Player starts the game");
+        TEXT("AI Player starts the game"));
 }
 
 void UTBS_GameInstance::SetTurnMessage(const FString& Message)
 {
+    // Players set the same message again and again, only a new text reaches the HUD
+    if (TurnMessage.Equals(Message, ESearchCase::CaseSensitive))
+    {
+        return;
+    }
+
     TurnMessage = Message;
+    OnTurnMessageChanged.Broadcast(TurnMessage);
 }
 
 // Move History Functions
-void UTBS_GameInstance::AddMoveToHistory(int32 PlayerIndex, const FString& UnitType, const FString& ActionType,
-    const FVector2D& FromPosition, const FVector2D& ToPosition, int32 Damage)
+void UTBS_GameInstance::AddMoveToHistory(const FTBSLogRecord& Record)
 {
-    // Format the player identifier
-    FString PlayerIdentifier = (PlayerIndex == 0) ? TEXT("HP") : TEXT("AI");
-
-    // Convert numerical coordinates to letter+number format -> Horizontal line will be identified by the y axys since the view is top-down
-    // Y axis: A-Y (0-24 in grid)
-    // X axis: 1-25 (0-24 in grid)
-    auto ConvertToGridFormat = [](const FVector2D& Position) -> FString
-        {
-            // Convert Y to a letter (A-Y)
-            TCHAR Letter = 'A' + static_cast<int32>(Position.Y);
-            // Convert X to a number (1-25)
-            int32 Number = static_cast<int32>(Position.X) + 1;
-
-            return FString::Printf(TEXT("%c%d"), Letter, Number);
-        };
-
-    // Format the move entry based on action type
-    FString MoveEntry;
-    if (ActionType == TEXT("Move"))
-    {
-        // Format: HP: S B4 -> D6
-        MoveEntry = FString::Printf(TEXT("%s: %s %s -> %s"), *PlayerIdentifier, *UnitType.Left(1), //First letter of the unit
-            *ConvertToGridFormat(FromPosition), *ConvertToGridFormat(ToPosition));
-    }
-    else if (ActionType == TEXT("Attack"))
-    {
-        // Format: HP: S G8 7
-        MoveEntry = FString::Printf(TEXT("%s: %s %s %d"), *PlayerIdentifier, *UnitType.Left(1), // First letter of unit type
-            *ConvertToGridFormat(ToPosition), Damage);
-    }
-    else if (ActionType == TEXT("Skip"))
-    {
-        // Format: HP: S Skip
-        MoveEntry = FString::Printf(TEXT("%s: %s Skip"), *PlayerIdentifier, *UnitType.Left(1)); // First letter of unit type
-    }
-    else if (ActionType == TEXT("Place"))
-    {
-        // Format: HP: S Place at D6
-        MoveEntry = FString::Printf(TEXT("%s: %s Place at %s"), *PlayerIdentifier, *UnitType.Left(1), // First letter of unit type
-            *ConvertToGridFormat(ToPosition));
-    }
-
-    // Add to history
-    MoveHistory.Add(MoveEntry);
+    ActionLog.Add(Record);
+    OnMoveHistoryAppended.Broadcast(ActionLog.Num() - 1, 1);
 }
 
 void UTBS_GameInstance::ClearMoveHistory()
 {
-    MoveHistory.Empty();
+    ActionLog.Reset();
+    OnMoveHistoryCleared.Broadcast();
 }
 
-FString UTBS_GameInstance::GetFormattedMoveHistory() const
+int32 UTBS_GameInstance::GetNumMoveHistoryLines() const
 {
-    FString History;
+    return ActionLog.Num();
+}
 
-    for (int32 i = 0; i < MoveHistory.Num(); i++)
-    {
-        if (i > 0)
-        {
-            History.Append(TEXT("\n"));
-        }
-        History.Append(MoveHistory[i]);
-    }
+FString UTBS_GameInstance::GetMoveHistoryLine(int32 LineIndex) const
+{
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_HistoryFormatting);
 
-    return History;
+    return (LineIndex >= 0 && LineIndex < ActionLog.Num()) ? ActionLog.FormatRecord(LineIndex) : FString();
 }
 
 // Game Statistics Functions
@@ -138,6 +103,8 @@ void UTBS_GameInstance::RecordGameResult(bool bPlayerWon)
     {
         ScoreAIPlayer++;
     }
+
+    BroadcastScores();
 }
 
 void UTBS_GameInstance::ResetGameStatistics()
@@ -148,6 +115,9 @@ void UTBS_GameInstance::ResetGameStatistics()
     CurrentRound = 1;
     ClearMoveHistory();
     ResetWinner(); // Reset the winner tracking
+
+    BroadcastScores();
+    OnRoundChanged.Broadcast(CurrentRound);
 }
 
 void UTBS_GameInstance::SetWinner(int32 WinnerIndex)
@@ -160,7 +130,7 @@ void UTBS_GameInstance::SetWinner(int32 WinnerIndex)
     // Only append winner message if not empty
     if (!WinnerMessage.IsEmpty())
     {
-        TurnMessage = TurnMessage + TEXT(" | ") + WinnerMessage;
+        SetTurnMessage(TurnMessage + TEXT(" | ") + WinnerMessage);
     }
 }
 
@@ -193,4 +163,16 @@ FString UTBS_GameInstance::GetWinnerMessage() const
 void UTBS_GameInstance::ResetWinner()
 {
     CurrentWinner = -1;
-}
\ No newline at end of file
+}
+
+void UTBS_GameInstance::BroadcastAllChanges()
+{
+    OnTurnMessageChanged.Broadcast(TurnMessage);
+    BroadcastScores();
+    OnRoundChanged.Broadcast(CurrentRound);
+}
+
+void UTBS_GameInstance::BroadcastScores()
+{
+    OnScoresChanged.Broadcast(ScoreHumanPlayer, ScoreAIPlayer, TotalGamesPlayed);
+}
@@ -7,6 +7,7 @@
 #include "TBS_HumanPlayer.h"
 #include "TBS_NaiveAI.h"
 #include "TBS_SmartAI.h"
+#include "TBS_MCTSAI.h"
 #include "AISelectionWidget.h"
 #include "TBS_PlayerController.h"
 #include "Blueprint/UserWidget.h"
@@ -16,6 +17,8 @@
 #include "TBS_PlayerInterface.h"
 #include "EngineUtils.h"
 #include "Components/Widget.h"
+#include "Misc/Paths.h"
+#include "TBSStats.h"
 
 ATBS_GameMode::ATBS_GameMode()
 {
@@ -28,6 +31,11 @@ ATBS_GameMode::ATBS_GameMode()
     UnitsPlaced = 0;
     bIsGameOver = false;
     ObstaclePercentage = 10.0f;     // Random default obstacle percentage
+    MapSeed = 0;                    // Random sequence of maps
+    MapPoolSize = 2;
+    CurrentMapSeed = 0;
+    MatchSeed = 0;                  // Random match
+    CurrentMatchSeed = 0;
 
     // Initialize unit placement tracking
     BrawlerPlaced.Init(false, NumberOfPlayers);
@@ -41,6 +49,8 @@ ATBS_GameMode::ATBS_GameMode()
 
     NaiveAIClass = ATBS_NaiveAI::StaticClass();
     SmartAIClass = ATBS_SmartAI::StaticClass();
+    MCTSAIClass = ATBS_MCTSAI::StaticClass();
+    bUseMCTSAI = false;
     AISelectionWidgetClass = UAISelectionWidget::StaticClass(); 
 
 }
@@ -49,6 +59,11 @@ void ATBS_GameMode::BeginPlay()
 {
     Super::BeginPlay();
 
+    // Seed the match before anything random happens, the only draw from the global generator
+    CurrentMatchSeed = (MatchSeed != 0) ? MatchSeed : FMath::RandRange(1, MAX_int32);
+    MatchRandom.Initialize(CurrentMatchSeed);
+    UE_LOG(LogTemp, Log, TEXT("Match seed: %d"), CurrentMatchSeed);
+
     // Initialize the Grid first
     if (GridClass != nullptr)
     {
@@ -57,6 +72,9 @@ void ATBS_GameMode::BeginPlay()
         {
             GameGrid->Size = GridSize;
             GameGrid->GenerateGrid(); // Ensure grid is generated before other operations
+
+            // Maps are generated while the player picks the AI
+            PrepareMapPool();
         }
         else
         {
@@ -102,12 +120,8 @@ void ATBS_GameMode::BeginPlay()
     Players.Empty();
     Players.Add(HumanPlayer);
 
-    // Set initial values for units per player
-    UnitsRemaining.SetNum(NumberOfPlayers);
-    for (int32 i = 0; i < NumberOfPlayers; i++)
-    {
-        UnitsRemaining[i] = UnitsPerPlayer;
-    }
+    // No unit on the board yet
+    ResetUnitRegistry();
 
     // Start with AI selection phase
     CurrentPhase = EGamePhase::AI_SELECTION;
@@ -459,13 +473,14 @@ void ATBS_GameMode::InitializeGame()
             AActor* AI = nullptr;
             if (bUseSmartAI)
             {
-                if (SmartAIClass)
+                TSubclassOf<AActor> HardAIClass = bUseMCTSAI ? MCTSAIClass : SmartAIClass;
+                if (HardAIClass)
                 {
-                    AI = GetWorld()->SpawnActor<AActor>(SmartAIClass, FVector(), FRotator());
+                    AI = GetWorld()->SpawnActor<AActor>(HardAIClass, FVector(), FRotator());
                 }
                 else
                 {
-                    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("SmartAIClass not set"));
+                    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, bUseMCTSAI ? TEXT("MCTSAIClass not set") : TEXT("SmartAIClass not set"));
                 }
             }
             else
@@ -489,12 +504,8 @@ void ATBS_GameMode::InitializeGame()
                 GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Failed to spawn AI Player"));
             }
 
-            // Set initial values for units per player
-            UnitsRemaining.SetNum(NumberOfPlayers);
-            for (int32 i = 0; i < NumberOfPlayers; i++)
-            {
-                UnitsRemaining[i] = UnitsPerPlayer;
-            }
+            // No unit on the board yet
+            ResetUnitRegistry();
 
             // Start the game with a coin toss
             int32 StartingPlayer = SimulateCoinToss();
@@ -506,11 +517,16 @@ void ATBS_GameMode::InitializeGame()
 int32 ATBS_GameMode::SimulateCoinToss()
 {
 
-    int32 StartingPlayer = FMath::RandRange(0, 1);
+    int32 StartingPlayer = MatchRandom.GetCoinToss().RandRange(0, 1);
 
     // Store the player who won the coin toss
     FirstPlayerIndex = StartingPlayer;
 
+    if (FTBSActionLog* ActionLog = GetActionLog())
+    {
+        ActionLog->SetStartingPlayer(StartingPlayer);
+    }
+
     // Get game instance and set the starting player message
     UTBS_GameInstance* GameInstance = Cast<UTBS_GameInstance>(GetGameInstance());
     if (GameInstance)
@@ -652,6 +668,11 @@ void ATBS_GameMode::StartGameplayPhase()
     // Reset to the player who won the coin toss for the gameplay phase
     CurrentPlayer = FirstPlayerIndex;
 
+    if (FTBSActionLog* ActionLog = GetActionLog())
+    {
+        ActionLog->BeginTurn();
+    }
+
     // Clear any UI widgets that might be causing interference
     if (UnitSelectionWidget && UnitSelectionWidget->IsInViewport())
     {
@@ -673,13 +694,9 @@ void ATBS_GameMode::StartGameplayPhase()
     }
 
     // Reset all units for new turn
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
-
-    for (AActor* Actor : AllUnits)
+    for (const FPlayerUnits& PlayerUnits : UnitRegistry)
     {
-        AUnit* Unit = Cast<AUnit>(Actor);
-        if (Unit)
+        for (AUnit* Unit : PlayerUnits.Units)
         {
             Unit->ResetTurn();
         }
@@ -730,6 +747,8 @@ void ATBS_GameMode::StartGameplayPhase()
 
 void ATBS_GameMode::EndTurn()
 {
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_EndTurn);
+
     // Hide the End Turn button
     ShowEndTurnButton(false);
 
@@ -748,17 +767,23 @@ void ATBS_GameMode::EndTurn()
         return;
     }
 
-    // Reset all units for the new player's turn
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
+    // A late EndTurn of the last round must not show up in the new log
+    FTBSActionLog* ActionLog = GetActionLog();
+    if (ActionLog && CurrentPhase == EGamePhase::GAMEPLAY)
+    {
+        ActionLog->BeginTurn();
+    }
 
-    for (AActor* Actor : AllUnits)
+    // Debug builds can check what the last turn changed on the board (tbs.ValidateGrid)
+    if (GameGrid)
     {
-        AUnit* Unit = Cast<AUnit>(Actor);
-        if (Unit && Unit->GetOwnerID() == CurrentPlayer)
-        {
-            Unit->ResetTurn();
-        }
+        GameGrid->ValidateDirtyCells();
+    }
+
+    // Reset all units for the new player's turn
+    for (AUnit* Unit : GetPlayerUnits(CurrentPlayer))
+    {
+        Unit->ResetTurn();
     }
 
     // Make sure to notify the new current player
@@ -774,6 +799,8 @@ void ATBS_GameMode::EndTurn()
 
 bool ATBS_GameMode::PlaceUnit(EUnitType Type, int32 GridX, int32 GridY, int32 PlayerIndex)
 {
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_PlaceUnit);
+
     // Early validation checks
     if (!GameGrid || CurrentPhase != EGamePhase::SETUP || PlayerIndex != CurrentPlayer)
     {
@@ -788,13 +815,7 @@ bool ATBS_GameMode::PlaceUnit(EUnitType Type, int32 GridX, int32 GridY, int32 Pl
     }
 
     // Validate tile
-    FVector2D Position(GridX, GridY);
-    if (!GameGrid->TileMap.Contains(Position))
-    {
-        return false;
-    }
-
-    ATile* Tile = GameGrid->TileMap[Position];
+    ATile* Tile = GameGrid->GetTile(GridX, GridY);
     if (!Tile || Tile->GetTileStatus() != ETileStatus::EMPTY)
     {
         return false;
@@ -824,24 +845,10 @@ bool ATBS_GameMode::PlaceUnit(EUnitType Type, int32 GridX, int32 GridY, int32 Pl
     // Initialize unit
     NewUnit->SetOwnerID(PlayerIndex);
     NewUnit->InitializePosition(Tile);
+    RegisterUnit(NewUnit);
 
-    // Get game instance to record move history
-    UTBS_GameInstance* GameInstance = Cast<UTBS_GameInstance>(GetGameInstance());
-    if (GameInstance)
-    {
-        // Format the unit type string
-        FString UnitTypeString = (Type == EUnitType::BRAWLER) ? "Brawler" : "Sniper";
-
-        // Record the placement move
-        GameInstance->AddMoveToHistory(
-            PlayerIndex,
-            UnitTypeString,
-            "Place",
-            FVector2D::ZeroVector,
-            FVector2D(GridX, GridY),
-            0
-        );
-    }
+    // Record the placement move
+    RecordMove(PlayerIndex, NewUnit, ETBSLogAction::Place, FVector2D(GridX, GridY), FVector2D(GridX, GridY));
 
     // Mark unit type as placed
     if (Type == EUnitType::BRAWLER)
@@ -897,35 +904,10 @@ bool ATBS_GameMode::CheckGameOver()
     bool bGameOver = false;
     int32 WinningPlayer = -1;
 
-    // Count each player's remaining units
-    TArray<AActor*> PlayerUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), PlayerUnits);
-
-    // Reset counters
-    UnitsRemaining.SetNum(NumberOfPlayers);
+    // Check if any player has lost all units (the registry keeps the counts exact)
     for (int32 i = 0; i < NumberOfPlayers; i++)
     {
-        UnitsRemaining[i] = 0;
-    }
-
-    // Count units by player
-    for (AActor* Actor : PlayerUnits)
-    {
-        AUnit* Unit = Cast<AUnit>(Actor);
-        if (Unit && !Unit->IsDead())
-        {
-            int32 OwnerID = Unit->GetOwnerID();
-            if (OwnerID >= 0 && OwnerID < NumberOfPlayers)
-            {
-                UnitsRemaining[OwnerID]++;
-            }
-        }
-    }
-
-    // Check if any player has lost all units
-    for (int32 i = 0; i < NumberOfPlayers; i++)
-    {
-        if (UnitsRemaining[i] == 0)
+        if (GetNumUnits(i) == 0)
         {
             bGameOver = true;
             WinningPlayer = (i + 1) % NumberOfPlayers; // Other player wins
@@ -948,11 +930,9 @@ bool ATBS_GameMode::CheckGameOver()
 
 void ATBS_GameMode::NotifyUnitDestroyed(int32 PlayerIndex)
 {
-    // Decrement the player's unit count
+    // The dead unit already left the registry, so the count is up to date
     if (UnitsRemaining.IsValidIndex(PlayerIndex))
     {
-        UnitsRemaining[PlayerIndex]--;
-
         // Check if the game is over with a slight delay to ensure all damage is processed
         FTimerHandle CheckGameOverTimerHandle;
         GetWorldTimerManager().SetTimer(CheckGameOverTimerHandle, [this]()
@@ -962,6 +942,134 @@ void ATBS_GameMode::NotifyUnitDestroyed(int32 PlayerIndex)
     }
 }
 
+void ATBS_GameMode::RegisterUnit(AUnit* Unit)
+{
+    if (!IsValid(Unit) || Unit->RegistryIndex != INDEX_NONE || !UnitRegistry.IsValidIndex(Unit->GetOwnerID()))
+    {
+        return;
+    }
+
+    const int32 PlayerIndex = Unit->GetOwnerID();
+    Unit->RegistryIndex = UnitRegistry[PlayerIndex].Units.Add(Unit);
+    UnitsRemaining[PlayerIndex] = UnitRegistry[PlayerIndex].Units.Num();
+}
+
+void ATBS_GameMode::UnregisterUnit(AUnit* Unit)
+{
+    if (!Unit || Unit->RegistryIndex == INDEX_NONE || !UnitRegistry.IsValidIndex(Unit->GetOwnerID()))
+    {
+        return;
+    }
+
+    const int32 PlayerIndex = Unit->GetOwnerID();
+    TArray<AUnit*>& Units = UnitRegistry[PlayerIndex].Units;
+    const int32 Index = Unit->RegistryIndex;
+    Unit->RegistryIndex = INDEX_NONE;
+
+    if (!Units.IsValidIndex(Index) || Units[Index] != Unit)
+    {
+        return;
+    }
+
+    // Move the last unit into the hole so the array stays dense
+    Units.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    if (Units.IsValidIndex(Index))
+    {
+        Units[Index]->RegistryIndex = Index;
+    }
+
+    UnitsRemaining[PlayerIndex] = Units.Num();
+}
+
+const TArray<AUnit*>& ATBS_GameMode::GetPlayerUnits(int32 PlayerIndex) const
+{
+    static const TArray<AUnit*> NoUnits;
+    return UnitRegistry.IsValidIndex(PlayerIndex) ? UnitRegistry[PlayerIndex].Units : NoUnits;
+}
+
+void ATBS_GameMode::GetEnemyUnits(int32 PlayerIndex, TArray<AUnit*>& OutUnits) const
+{
+    OutUnits.Reset();
+    for (int32 i = 0; i < UnitRegistry.Num(); i++)
+    {
+        if (i != PlayerIndex)
+        {
+            OutUnits.Append(UnitRegistry[i].Units);
+        }
+    }
+}
+
+int32 ATBS_GameMode::GetNumUnits(int32 PlayerIndex) const
+{
+    return UnitRegistry.IsValidIndex(PlayerIndex) ? UnitRegistry[PlayerIndex].Units.Num() : 0;
+}
+
+void ATBS_GameMode::ResetUnitRegistry()
+{
+    for (const FPlayerUnits& PlayerUnits : UnitRegistry)
+    {
+        for (AUnit* Unit : PlayerUnits.Units)
+        {
+            if (Unit)
+            {
+                Unit->RegistryIndex = INDEX_NONE;
+            }
+        }
+    }
+
+    UnitRegistry.Reset();
+    UnitRegistry.SetNum(NumberOfPlayers);
+    UnitsRemaining.Init(0, NumberOfPlayers);
+}
+
+bool ATBS_GameMode::CaptureGameState(FTBSGameState& OutState, TArray<AUnit*>& OutUnits) const
+{
+    OutUnits.Reset();
+    if (!GameGrid)
+    {
+        return false;
+    }
+
+    OutState.Init(GameGrid->Size);
+    GameGrid->GetObstacleBits().ForEachSetBit([&OutState](const int32 Index)
+        {
+            OutState.SetObstacle(Index);
+        });
+
+    for (const FPlayerUnits& PlayerUnits : UnitRegistry)
+    {
+        for (AUnit* Unit : PlayerUnits.Units)
+        {
+            ATile* UnitTile = Unit->GetCurrentTile();
+            if (!UnitTile)
+            {
+                continue;
+            }
+
+            FTBSUnitState UnitState;
+            UnitState.Type = Unit->GetUnitType();
+            UnitState.Owner = Unit->GetOwnerID();
+            UnitState.bMoved = Unit->HasMoved();
+            UnitState.bAttacked = Unit->HasAttacked();
+            UnitState.Cell = UnitTile->GetCellIndex();
+            UnitState.Health = Unit->GetUnitHealth();
+            UnitState.MaxHealth = Unit->GetMaxHealth();
+            UnitState.MovementRange = Unit->GetMovementRange();
+            UnitState.AttackRange = Unit->GetAttackRange();
+            UnitState.MinDamage = Unit->GetMinDamage();
+            UnitState.MaxDamage = Unit->GetMaxDamage();
+
+            if (OutState.AddUnit(UnitState) != INDEX_NONE)
+            {
+                OutUnits.Add(Unit);
+            }
+        }
+    }
+
+    OutState.SetSideToMove(CurrentPlayer);
+    return true;
+}
+
 AActor* ATBS_GameMode::GetCurrentPlayer()
 {
     if (Players.IsValidIndex(CurrentPlayer))
@@ -986,31 +1094,11 @@ void ATBS_GameMode::PlayerWon(int32 PlayerIndex)
     // Check for a draw scenario
     bool bIsDraw = false;
 
-    // Count remaining units for each player
-    TArray<AActor*> PlayerUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), PlayerUnits);
-
-    TArray<int32> RemainingUnitsPerPlayer;
-    RemainingUnitsPerPlayer.SetNum(NumberOfPlayers);
-
-    for (AActor* Actor : PlayerUnits)
-    {
-        AUnit* Unit = Cast<AUnit>(Actor);
-        if (Unit && !Unit->IsDead())
-        {
-            int32 OwnerID = Unit->GetOwnerID();
-            if (OwnerID >= 0 && OwnerID < NumberOfPlayers)
-            {
-                RemainingUnitsPerPlayer[OwnerID]++;
-            }
-        }
-    }
-
     // Check if both players have 0 units
     bool bAllPlayersOutOfUnits = true;
-    for (int32 UnitCount : RemainingUnitsPerPlayer)
+    for (int32 i = 0; i < NumberOfPlayers; i++)
     {
-        if (UnitCount > 0)
+        if (GetNumUnits(i) > 0)
         {
             bAllPlayersOutOfUnits = false;
             break;
@@ -1136,37 +1224,30 @@ void ATBS_GameMode::ResetForNewRound(int32 WinnerIndex)
     FTimerHandle TimerHandle;
     GetWorldTimerManager().SetTimer(TimerHandle, [this]()
         {
-            // Reset remaining units count
-            UnitsRemaining.SetNum(NumberOfPlayers);
-            for (int32 i = 0; i < NumberOfPlayers; i++)
+            // Remove all units from the grid (destroying a unit unregisters it, so walk a copy)
+            TArray<AUnit*> AllUnits;
+            for (const FPlayerUnits& PlayerUnits : UnitRegistry)
             {
-                UnitsRemaining[i] = UnitsPerPlayer;
+                AllUnits.Append(PlayerUnits.Units);
             }
 
-            // Remove all units from the grid
-            TArray<AActor*> AllUnits;
-            UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
-            for (AActor* UnitActor : AllUnits)
+            for (AUnit* Unit : AllUnits)
             {
-                if (UnitActor)
+                // Clean up its tile
+                ATile* CurrentTile = Unit->GetCurrentTile();
+                if (CurrentTile)
                 {
-                    // Get the unit reference
-                    AUnit* Unit = Cast<AUnit>(UnitActor);
-                    if (Unit)
-                    {
-                        // Clean up its tile
-                        ATile* CurrentTile = Unit->GetCurrentTile();
-                        if (CurrentTile)
-                        {
-                            CurrentTile->SetTileStatus(AGrid::NOT_ASSIGNED, ETileStatus::EMPTY);
-                            CurrentTile->SetOccupyingUnit(nullptr);
-                        }
-                    }
-                    // Destroy the unit
-                    UnitActor->Destroy();
+                    CurrentTile->SetTileStatus(AGrid::NOT_ASSIGNED, ETileStatus::EMPTY);
+                    CurrentTile->SetOccupyingUnit(nullptr);
                 }
+
+                // Destroy the unit
+                Unit->Destroy();
             }
 
+            // Reset remaining units count
+            ResetUnitRegistry();
+
             // Reset the grid and regenerate obstacles
             if (GameGrid)
             {
@@ -1187,6 +1268,10 @@ void ATBS_GameMode::ResetForNewRound(int32 WinnerIndex)
                 {
                     AIPlayer->ResetActionState();
                 }
+                else if (ATBS_SmartAI* SmartAIPlayer = Cast<ATBS_SmartAI>(PlayerActor))
+                {
+                    SmartAIPlayer->ResetActionState();
+                }
             }
 
             // Add an additional delay before starting the new placement phase to ensure UI is reset
@@ -1201,375 +1286,118 @@ void ATBS_GameMode::ResetForNewRound(int32 WinnerIndex)
         }, 1.0f, false);
 }
 
-void ATBS_GameMode::RecordMove(int32 PlayerIndex, FString UnitType, FString ActionType,
+void ATBS_GameMode::RecordMove(int32 PlayerIndex, AUnit* Unit, ETBSLogAction Action,
     FVector2D FromPosition, FVector2D ToPosition, int32 Damage)
 {
     UTBS_GameInstance* GameInstance = Cast<UTBS_GameInstance>(GetGameInstance());
-
-    GameInstance->AddMoveToHistory(PlayerIndex, UnitType, ActionType, FromPosition, ToPosition, Damage);
-
-}
-
-bool ATBS_GameMode::WouldBreakConnectivity(int32 GridX, int32 GridY)
-{
-    if (!GameGrid)
+    if (!GameInstance || !Unit || (Action == ETBSLogAction::Attack && Damage <= 0))
     {
-        return true;
-    }
-
-    // Get the tile at the specified position
-    FVector2D Position(GridX, GridY);
-
-    if (!GameGrid->TileMap.Contains(Position))
-    {
-        return true;
+        return;
     }
 
-    ATile* Tile = GameGrid->TileMap[Position];
+    FTBSLogRecord Record;
+    Record.Action = Action;
+    Record.Player = static_cast<uint8>(PlayerIndex);
+    Record.Unit = Unit->GetUnitType();
 
-    // Skip if the tile is already an obstacle or occupied
-    if (!Tile || Tile->GetTileStatus() != ETileStatus::EMPTY || Tile->IsObstacle())
+    if (Action != ETBSLogAction::Skip)
     {
-        return true;
+        Record.FromCell = static_cast<uint16>(GameInstance->ActionLog.GetCell(FromPosition));
+        Record.ToCell = static_cast<uint16>(GameInstance->ActionLog.GetCell(ToPosition));
     }
 
-    // Temporarily mark this tile as an obstacle
-    ETileStatus OriginalStatus = Tile->GetTileStatus();
-    int32 OriginalOwner = Tile->GetOwner();
-
-    // Set as obstacle
-    Tile->SetTileStatus(-2, ETileStatus::OCCUPIED);
-    // Explicitly mark as obstacle using function if available
-    if (UFunction* Function = Tile->FindFunction(TEXT("SetObstacleMaterial")))
+    if (Action == ETBSLogAction::Attack)
     {
-        Tile->ProcessEvent(Function, nullptr);
+        Record.Damage = static_cast<uint8>(FMath::Min(Damage, int32(MAX_uint8)));
+        Record.CounterDamage = static_cast<uint8>(FMath::Min(Unit->GetLastCounterDamage(), int32(MAX_uint8)));
     }
 
-    // Check if the grid is still connected
-    bool IsConnected = GameGrid->ValidateConnectivity();
-
-    // Restore the tile's original state
-    Tile->SetTileStatus(OriginalOwner, OriginalStatus);
+    GameInstance->AddMoveToHistory(Record);
+}
 
-    // Return true if placing an obstacle here would break connectivity
-    return !IsConnected;
+FTBSActionLog* ATBS_GameMode::GetActionLog() const
+{
+    UTBS_GameInstance* GameInstance = Cast<UTBS_GameInstance>(GetGameInstance());
+    return GameInstance ? &GameInstance->ActionLog : nullptr;
 }
 
-// Percentage-based obstacle spawning
-// Modified obstacle spawning function with improved enclosure prevention
-void ATBS_GameMode::SpawnObstaclesWithConnectivity()
+void ATBS_GameMode::SaveReplay()
 {
-    if (!GameGrid)
+    FTBSActionLog* ActionLog = GetActionLog();
+    if (!ActionLog)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Error: GameGrid is null"));
         return;
     }
 
-    // Reset all tiles to empty to ensure a clean start
-    for (ATile* Tile : GameGrid->TileArray)
-    {
-        if (Tile)
-        {
-            // Clear any highlights
-            Tile->ClearHighlight();
-
-            // Reset all tiles to empty state
-            Tile->SetTileStatus(AGrid::NOT_ASSIGNED, ETileStatus::EMPTY);
-        }
-    }
-
-    // Calculate target obstacles based on percentage
-    int32 TotalTileCount = GameGrid->Size * GameGrid->Size;
-    int32 TargetObstacles = FMath::RoundToInt((ObstaclePercentage / 100.0f) * TotalTileCount);
+    const FString FileName = FPaths::ProjectSavedDir() / TEXT("Replays") /
+        FString::Printf(TEXT("Match%d_Map%d_%s.tbslog"), ActionLog->GetMatchSeed(), ActionLog->GetMapSeed(), *FDateTime::Now().ToString());
 
-    // Cap at 70% maximum
-    int32 MaxObstacles = FMath::RoundToInt(0.7f * TotalTileCount);
-    TargetObstacles = FMath::Min(TargetObstacles, MaxObstacles);
-
-    // Track all obstacle positions explicitly
-    TArray<FVector2D> ObstaclePositions;
-
-    float StepSize = FMath::Sqrt(100.0f / ObstaclePercentage);  // Adjust spacing based on percentage
-    StepSize = FMath::Max(StepSize, 1.5f);                      // Ensure minimum spacing
-
-    TArray<FVector2D> PatternPositions;
-
-    // Create a grid pattern with spacing based on percentage
-    for (float x = 0.0f; x < GameGrid->Size - 1; x += StepSize)
+    if (ActionLog->SaveToFile(FileName))
     {
-        for (float y = 0.0f; y < GameGrid->Size - 1; y += StepSize)
-        {
-            // Add some randomness to avoid perfect grid patterns
-            float offsetX = FMath::FRandRange(-0.3f, 0.3f) * StepSize;
-            float offsetY = FMath::FRandRange(-0.3f, 0.3f) * StepSize;
-
-            int32 gridX = FMath::RoundToInt(x + offsetX);
-            int32 gridY = FMath::RoundToInt(y + offsetY);
-
-            // Ensure we're within grid bounds
-            if (gridX >= 0 && gridX < GameGrid->Size &&
-                gridY >= 0 && gridY < GameGrid->Size)
-            {
-                PatternPositions.Add(FVector2D(gridX, gridY));
-            }
-        }
+        UE_LOG(LogTemp, Display, TEXT("Replay saved to %s (%d actions)"), *FileName, ActionLog->Num());
     }
-
-    // Shuffle positions for more randomness
-    for (int32 i = PatternPositions.Num() - 1; i > 0; i--)
+    else
     {
-        int32 SwapIndex = FMath::RandRange(0, i);
-        if (i != SwapIndex)
-        {
-            PatternPositions.Swap(i, SwapIndex);
-        }
+        UE_LOG(LogTemp, Error, TEXT("Could not save the replay to %s"), *FileName);
     }
+}
 
-    // Place obstacles from the pattern
-    int32 PlacedObstacles = 0;
+// Starts generating the obstacle layouts of the next rounds in the background
+void ATBS_GameMode::PrepareMapPool()
+{
+    if (!GameGrid)
+        return;
 
-    // Try the patterned positions
-    for (const FVector2D& Pos : PatternPositions)
+    if (!MapPool.IsValid())
     {
-        if (PlacedObstacles >= TargetObstacles)
-            break;
-
-        if (!GameGrid->TileMap.Contains(Pos))
-            continue;
-
-        ATile* Tile = GameGrid->TileMap[Pos];
-
-        // Skip invalid tiles
-        if (!Tile || Tile->GetOccupyingUnit())
-            continue;
-
-        // Don't completely block any adjacent empty tile
-        bool WouldBlockAdjacent = false;
-        TArray<FVector2D> Directions = {
-            FVector2D(0, 1), FVector2D(0, -1), FVector2D(1, 0), FVector2D(-1, 0)
-        };
-
-        for (const FVector2D& Dir : Directions)
-        {
-            FVector2D AdjPos = Pos + Dir;
-
-            if (!GameGrid->TileMap.Contains(AdjPos))
-                continue;
-
-            ATile* AdjTile = GameGrid->TileMap[AdjPos];
-            if (!AdjTile || AdjTile->GetOccupyingUnit())
-                continue;
-
-            // Check if all other sides of this adjacent tile are blocked
-            int32 BlockedSides = 0;
-            for (const FVector2D& CheckDir : Directions)
-            {
-                if (CheckDir == Dir * -1)  // Skip the direction we came from
-                    continue;
-
-                FVector2D CheckPos = AdjPos + CheckDir;
-
-                if (!GameGrid->TileMap.Contains(CheckPos))
-                {
-                    BlockedSides++;  // Edge of grid is a block
-                    continue;
-                }
-
-                ATile* CheckTile = GameGrid->TileMap[CheckPos];
-                if (!CheckTile || ObstaclePositions.Contains(CheckPos))
-                {
-                    BlockedSides++;
-                }
-            }
-
-            // If all sides would be blocked, this would isolate the tile
-            if (BlockedSides >= 2)  // 2+ other sides blocked (plus our potential obstacle = 3+)
-            {
-                WouldBlockAdjacent = true;
-                break;
-            }
-        }
-
-        if (!WouldBlockAdjacent)
-        {
-            // Track this position as an obstacle
-            ObstaclePositions.Add(Pos);
-            PlacedObstacles++;
-        }
+        MapPool = MakeShared<FMapPool, ESPMode::ThreadSafe>();
     }
 
-    // If we didn't reach the target, try randomized positions
-    if (PlacedObstacles < TargetObstacles)
+    // A new sequence is only needed if the board settings changed
+    if (!MapPool->Matches(GameGrid->Size, ObstaclePercentage))
     {
-        // Create completely random positions
-        TArray<FVector2D> RandomPositions;
-        for (int32 x = 0; x < GameGrid->Size; x++)
-        {
-            for (int32 y = 0; y < GameGrid->Size; y++)
-            {
-                // Skip positions already used
-                if (ObstaclePositions.Contains(FVector2D(x, y)))
-                    continue;
-
-                RandomPositions.Add(FVector2D(x, y));
-            }
-        }
-
-        // Shuffle positions
-        for (int32 i = RandomPositions.Num() - 1; i > 0; i--)
-        {
-            int32 SwapIndex = FMath::RandRange(0, i);
-            if (i != SwapIndex)
-            {
-                RandomPositions.Swap(i, SwapIndex);
-            }
-        }
-
-        // Try to place more obstacles
-        for (const FVector2D& Pos : RandomPositions)
-        {
-            if (PlacedObstacles >= TargetObstacles)
-                break;
-
-            if (!GameGrid->TileMap.Contains(Pos))
-                continue;
-
-            ATile* Tile = GameGrid->TileMap[Pos];
-
-            // Skip invalid tiles
-            if (!Tile || Tile->GetOccupyingUnit())
-                continue;
-
-            // Set as temporary obstacle for connectivity check
-            // First add to obstacle positions
-            ObstaclePositions.Add(Pos);
-
-            // Simple connectivity check
-            bool IsConnected = true;
-
-            // Clear all tiles
-            for (ATile* ClearTile : GameGrid->TileArray)
-            {
-                if (ClearTile)
-                {
-                    ClearTile->SetTileStatus(AGrid::NOT_ASSIGNED, ETileStatus::EMPTY);
-                }
-            }
-
-            // Set obstacles for testing
-            for (const FVector2D& ObsPos : ObstaclePositions)
-            {
-                if (GameGrid->TileMap.Contains(ObsPos))
-                {
-                    ATile* ObsTile = GameGrid->TileMap[ObsPos];
-                    if (ObsTile)
-                    {
-                        ObsTile->SetTileStatus(-2, ETileStatus::OCCUPIED);
-                    }
-                }
-            }
-
-            // Count total empty tiles and find first empty tile
-            int32 TotalEmptyTiles = 0;
-            ATile* StartTile = nullptr;
-
-            // Find first empty tile & count all empty tiles
-            for (ATile* CountTile : GameGrid->TileArray)
-            {
-                if (CountTile && CountTile->GetTileStatus() == ETileStatus::EMPTY)
-                {
-                    TotalEmptyTiles++;
-                    if (!StartTile)
-                    {
-                        StartTile = CountTile;
-                    }
-                }
-            }
-
-            if (StartTile)
-            {
-                // BFS to count reachable tiles
-                TArray<ATile*> Queue;
-                TSet<ATile*> Visited;
-
-                Queue.Add(StartTile);
-                Visited.Add(StartTile);
-
-                while (Queue.Num() > 0)
-                {
-                    ATile* CurrentTile = Queue[0];
-                    Queue.RemoveAt(0);
-
-                    FVector2D CurPos = CurrentTile->GetGridPosition();
-
-                    // Check 4 cardinal directions
-                    TArray<FVector2D> Directions = {FVector2D(0, 1), FVector2D(0, -1), FVector2D(1, 0), FVector2D(-1, 0)};
+        // Without a fixed map seed the maps follow the match seed
+        const int32 BaseSeed = (MapSeed != 0) ? MapSeed : MatchRandom.GetMap().RandRange(1, MAX_int32);
+        MapPool->Configure(GameGrid->Size, ObstaclePercentage, BaseSeed, MapPoolSize);
+    }
 
-                    for (const FVector2D& Dir : Directions)
-                    {
-                        FVector2D NewPos = CurPos + Dir;
+    MapPool->Refill();
+}
 
-                        if (!GameGrid->TileMap.Contains(NewPos))
-                            continue;
+// Percentage-based obstacle spawning, the layout comes from the pool of pre-generated maps
+void ATBS_GameMode::SpawnObstaclesWithConnectivity()
+{
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_SpawnObstacles);
 
-                        ATile* NextTile = GameGrid->TileMap[NewPos];
+    if (!GameGrid)
+    {
+        GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Error: GameGrid is null"));
+        return;
+    }
 
-                        if (!NextTile || Visited.Contains(NextTile) ||
-                            NextTile->GetTileStatus() == ETileStatus::OCCUPIED)
-                            continue;
+    // The board is fresh from GenerateGrid or cleared by ResetGrid, only the new obstacles are written
+    PrepareMapPool();
 
-                        Visited.Add(NextTile);
-                        Queue.Add(NextTile);
-                    }
-                }
+    FMapLayout Layout;
+    MapPool->Pop(Layout);
+    CurrentMapSeed = Layout.Seed;
 
-                // If not all empty tiles are reached, there's a connectivity problem
-                if (Visited.Num() < TotalEmptyTiles)
-                {
-                    IsConnected = false;
-                }
-            }
+    UE_LOG(LogTemp, Log, TEXT("Map seed %d: %d obstacles (%.1f%%)"), Layout.Seed, Layout.NumObstacles, Layout.ObstaclePercentage);
 
-            // Revert all tiles to empty again
-            for (ATile* ClearTile : GameGrid->TileArray)
-            {
-                if (ClearTile)
-                {
-                    ClearTile->SetTileStatus(AGrid::NOT_ASSIGNED, ETileStatus::EMPTY);
-                }
-            }
-
-            // Keep obstacle if connectivity is maintained
-            if (IsConnected)
-            {
-                PlacedObstacles++;
-            }
-            else
-            {
-                // Remove obstacle from the list
-                ObstaclePositions.RemoveAt(ObstaclePositions.Num() - 1);
-            }
-        }
+    // Everything a replay needs to rebuild this map
+    if (FTBSActionLog* ActionLog = GetActionLog())
+    {
+        ActionLog->BeginRound(CurrentMatchSeed, Layout.Seed, GameGrid->Size, Layout.ObstaclePercentage);
     }
 
-    // Final obstacle positions, set them all at once
-    for (const FVector2D& ObsPos : ObstaclePositions)
-    {
-        if (GameGrid->TileMap.Contains(ObsPos))
+    // Final obstacle positions, set them all at once on the cells: an instanced board spawns no tile for them
+    Layout.Obstacles.ForEachSetBit([this](const int32 Index)
         {
-            ATile* ObsTile = GameGrid->TileMap[ObsPos];
-            if (ObsTile)
-            {
-                // Set as obstacle
-                ObsTile->SetAsObstacle();
-            }
-        }
-    }
+            GameGrid->SetCellObstacle(Index, true);
+        });
 
-    //// Final report
-    //GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green,
-    //    FString::Printf(TEXT("Successfully placed %d obstacles (%.1f%%)"),
-    //        PlacedObstacles, (float)PlacedObstacles / TotalTileCount * 100.0f));
+    // Replace the map we just used while the round is played
+    MapPool->Refill();
 }
 
 void ATBS_GameMode::ShowEndTurnButton(bool bShow)
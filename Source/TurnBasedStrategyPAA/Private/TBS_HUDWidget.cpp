@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TBS_HUDWidget.h"
+#include "Components/ProgressBar.h"
+#include "Components/TextBlock.h"
+#include "GameFramework/PlayerController.h"
+#include "MoveHistoryWidget.h"
+#include "TBS_GameInstance.h"
+#include "TBS_HumanPlayer.h"
+#include "Unit.h"
+
+void UTBS_HUDWidget::NativeConstruct()
+{
+    Super::NativeConstruct();
+
+    if (UTBS_GameInstance* GameInstance = GetGameInstance<UTBS_GameInstance>())
+    {
+        GameInstance->OnTurnMessageChanged.AddUniqueDynamic(this, &UTBS_HUDWidget::OnTurnMessageChanged);
+        GameInstance->OnScoresChanged.AddUniqueDynamic(this, &UTBS_HUDWidget::OnScoresChanged);
+        GameInstance->OnRoundChanged.AddUniqueDynamic(this, &UTBS_HUDWidget::OnRoundChanged);
+
+        // Fill the texts with the values set before the HUD was created
+        GameInstance->BroadcastAllChanges();
+    }
+
+    if (APlayerController* PlayerController = GetOwningPlayer())
+    {
+        PlayerController->OnPossessedPawnChanged.AddUniqueDynamic(this, &UTBS_HUDWidget::OnPossessedPawnChanged);
+        BindHumanPlayer(Cast<ATBS_HumanPlayer>(PlayerController->GetPawn()));
+    }
+}
+
+void UTBS_HUDWidget::NativeDestruct()
+{
+    if (UTBS_GameInstance* GameInstance = GetGameInstance<UTBS_GameInstance>())
+    {
+        GameInstance->OnTurnMessageChanged.RemoveDynamic(this, &UTBS_HUDWidget::OnTurnMessageChanged);
+        GameInstance->OnScoresChanged.RemoveDynamic(this, &UTBS_HUDWidget::OnScoresChanged);
+        GameInstance->OnRoundChanged.RemoveDynamic(this, &UTBS_HUDWidget::OnRoundChanged);
+    }
+
+    if (APlayerController* PlayerController = GetOwningPlayer())
+    {
+        PlayerController->OnPossessedPawnChanged.RemoveDynamic(this, &UTBS_HUDWidget::OnPossessedPawnChanged);
+    }
+
+    BindHumanPlayer(nullptr);
+
+    Super::NativeDestruct();
+}
+
+void UTBS_HUDWidget::OnTurnMessageChanged(const FString& Message)
+{
+    if (PlayerTurn)
+    {
+        PlayerTurn->SetText(FText::FromString(Message));
+    }
+}
+
+void UTBS_HUDWidget::OnScoresChanged(int32 HumanScore, int32 AIScoreValue, int32 GamesPlayed)
+{
+    if (PlayerScore)
+    {
+        PlayerScore->SetText(FText::AsNumber(HumanScore));
+    }
+
+    if (AIScore)
+    {
+        AIScore->SetText(FText::AsNumber(AIScoreValue));
+    }
+
+    if (TotalGamesCounter)
+    {
+        TotalGamesCounter->SetText(FText::AsNumber(GamesPlayed));
+    }
+}
+
+void UTBS_HUDWidget::OnRoundChanged(int32 Round)
+{
+    if (TurnCounter)
+    {
+        TurnCounter->SetText(FText::AsNumber(Round));
+    }
+}
+
+void UTBS_HUDWidget::OnSelectionMessageChanged(const FString& Message)
+{
+    if (SelectedUnit)
+    {
+        SelectedUnit->SetText(FText::FromString(Message));
+    }
+}
+
+void UTBS_HUDWidget::OnLastClickedUnitChanged(AUnit* Unit)
+{
+    BindUnit(Unit);
+}
+
+void UTBS_HUDWidget::OnUnitHealthChanged(AUnit* Unit, int32 Health, int32 MaxHealth)
+{
+    if (HpLiveCount)
+    {
+        HpLiveCount->SetText(FText::FromString(Unit->GetLiveHealth()));
+    }
+
+    if (UnitsHealthBar)
+    {
+        UnitsHealthBar->SetPercent(MaxHealth > 0 ? static_cast<float>(Health) / MaxHealth : 0.f);
+    }
+}
+
+void UTBS_HUDWidget::OnPossessedPawnChanged(APawn* OldPawn, APawn* NewPawn)
+{
+    BindHumanPlayer(Cast<ATBS_HumanPlayer>(NewPawn));
+}
+
+void UTBS_HUDWidget::BindHumanPlayer(ATBS_HumanPlayer* Player)
+{
+    if (ATBS_HumanPlayer* OldPlayer = BoundPlayer.Get())
+    {
+        OldPlayer->OnSelectionMessageChanged.RemoveDynamic(this, &UTBS_HUDWidget::OnSelectionMessageChanged);
+        OldPlayer->OnLastClickedUnitChanged.RemoveDynamic(this, &UTBS_HUDWidget::OnLastClickedUnitChanged);
+    }
+
+    BoundPlayer = Player;
+
+    if (!Player)
+    {
+        BindUnit(nullptr);
+        return;
+    }
+
+    Player->OnSelectionMessageChanged.AddUniqueDynamic(this, &UTBS_HUDWidget::OnSelectionMessageChanged);
+    Player->OnLastClickedUnitChanged.AddUniqueDynamic(this, &UTBS_HUDWidget::OnLastClickedUnitChanged);
+
+    // The player only broadcasts changes, the current values are pushed once here
+    OnSelectionMessageChanged(Player->GetSelectionMessage());
+    BindUnit(Player->LastClickedUnit);
+}
+
+void UTBS_HUDWidget::BindUnit(AUnit* Unit)
+{
+    if (AUnit* OldUnit = BoundUnit.Get())
+    {
+        OldUnit->OnHealthChanged.RemoveDynamic(this, &UTBS_HUDWidget::OnUnitHealthChanged);
+    }
+
+    BoundUnit = Unit;
+
+    if (!IsValid(Unit))
+    {
+        for (UTextBlock* Text : { UnitSelected, HpLiveCount, InfoDamage, InfoMovement, InfoRange })
+        {
+            if (Text)
+            {
+                Text->SetText(FText::GetEmpty());
+            }
+        }
+
+        if (UnitsHealthBar)
+        {
+            UnitsHealthBar->SetPercent(0.f);
+        }
+        return;
+    }
+
+    Unit->OnHealthChanged.AddUniqueDynamic(this, &UTBS_HUDWidget::OnUnitHealthChanged);
+
+    // Name and stats don't change during a match, only the health is followed
+    if (UnitSelected)
+    {
+        UnitSelected->SetText(FText::FromString(Unit->GetUnitName()));
+    }
+
+    if (InfoDamage)
+    {
+        InfoDamage->SetText(FText::FromString(FString::Printf(TEXT("%d - %d"), Unit->GetMinDamage(), Unit->GetMaxDamage())));
+    }
+
+    if (InfoMovement)
+    {
+        InfoMovement->SetText(FText::AsNumber(Unit->GetMovementRange()));
+    }
+
+    if (InfoRange)
+    {
+        InfoRange->SetText(FText::AsNumber(Unit->GetAttackRange()));
+    }
+
+    OnUnitHealthChanged(Unit, Unit->GetUnitHealth(), Unit->GetMaxHealth());
+}
@@ -99,6 +99,8 @@ void ATBS_HumanPlayer::OnTurn_Implementation()
 	{
 		GameMode->ShowEndTurnButton(true);
 	}
+
+	RefreshSelectionMessage();
 }
 
 void ATBS_HumanPlayer::OnWin_Implementation()
@@ -158,17 +160,11 @@ void ATBS_HumanPlayer::FindMyUnits()
 {
 	MyUnits.Empty();
 
-	// Find all units of this player
-	TArray<AActor*> AllUnits;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
-
-	for (AActor* Actor : AllUnits)
+	// Units of this player, straight from the game mode's registry
+	ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode)
 	{
-		AUnit* Unit = Cast<AUnit>(Actor);
-		if (Unit && Unit->GetOwnerID() == PlayerNumber)
-		{
-			MyUnits.Add(Unit);
-		}
+		MyUnits = GameMode->GetPlayerUnits(PlayerNumber);
 	}
 }
 
@@ -181,42 +177,34 @@ void ATBS_HumanPlayer::OnClick()
 		return;
 	}
 
-	// Get hit result under cursor
-	FHitResult Hit;
-	bool bHitSuccessful = GetWorld()->GetFirstPlayerController()->GetHitResultUnderCursor(
-		ECollisionChannel::ECC_Visibility, false, Hit);
-
-	if (!bHitSuccessful)
+	APlayerController* PC = GetWorld()->GetFirstPlayerController();
+	if (!PC)
 	{
 		return;
 	}
 
-	// Prioritize direct hits on Tile or Unit
-	ATile* ClickedTile = Cast<ATile>(Hit.GetActor());
-	AUnit* ClickedUnit = Cast<AUnit>(Hit.GetActor());
-
-	// If a unit was clicked, get its tile
-	if (ClickedUnit)
+	// A single trace, only to pick a unit standing over its tile
+	AUnit* ClickedUnit = nullptr;
+	FHitResult Hit;
+	if (PC->GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, false, Hit))
 	{
-		ClickedTile = ClickedUnit->GetCurrentTile();
+		ClickedUnit = Cast<AUnit>(Hit.GetActor());
 	}
 
-	// If no tile found through direct hit, try grid conversion
+	// If a unit was clicked, get its tile
+	ATile* ClickedTile = ClickedUnit ? ClickedUnit->GetCurrentTile() : nullptr;
+
+	// Otherwise the cell comes from the cursor ray and the board plane, whatever the trace hit
 	if (!ClickedTile)
 	{
-		AGrid* Grid = GameMode->GameGrid;
-		FVector2D GridPos = Grid->GetXYPositionByRelativeLocation(Hit.Location);
-		int32 GridX = FMath::FloorToInt(GridPos.X);
-		int32 GridY = FMath::FloorToInt(GridPos.Y);
-
-		// Check if grid position is valid
-		if (GridX >= 0 && GridX < Grid->Size && GridY >= 0 && GridY < Grid->Size)
+		FVector RayOrigin;
+		FVector RayDirection;
+		if (PC->DeprojectMousePositionToWorld(RayOrigin, RayDirection))
 		{
-			FVector2D TilePos(GridX, GridY);
-			if (Grid->TileMap.Contains(TilePos))
-			{
-				ClickedTile = Grid->TileMap[TilePos];
-			}
+			AGrid* Grid = GameMode->GameGrid;
+
+			// Out of grid positions return no tile
+			ClickedTile = Grid->GetTileByIndex(Grid->GetCellIndexByRay(RayOrigin, RayDirection));
 		}
 	}
 
@@ -230,6 +218,7 @@ void ATBS_HumanPlayer::OnClick()
 	if (GameMode->CurrentPhase == EGamePhase::GAMEPLAY && CurrentAction == EPlayerAction::PLACEMENT)
 	{
 		CurrentAction = EPlayerAction::NONE;
+		RefreshSelectionMessage();
 	}
 
 	// Handle Setup/Placement Phase
@@ -276,7 +265,7 @@ void ATBS_HumanPlayer::OnClick()
 			if (UnitOnTile)
 			{
 				// Always update LastClickedUnit for HUD display
-				LastClickedUnit = UnitOnTile;
+				SetLastClickedUnit(UnitOnTile);
 
 				// Unit selection logic - ensure ownership check is correct
 				if (UnitOnTile->GetOwnerID() == PlayerNumber)
@@ -312,19 +301,8 @@ void ATBS_HumanPlayer::OnClick()
 		case EPlayerAction::MOVEMENT:
 			if (SelectedUnit && !SelectedUnit->HasMoved())
 			{
-				TArray<ATile*> MovementTiles = SelectedUnit->GetMovementTiles();
-
-				ATile* MatchedTile = nullptr;
-				for (ATile* MovementTile : MovementTiles)
-				{
-					// Compare grid positions precisely
-					if (MovementTile->GetGridPosition().X == ClickedTile->GetGridPosition().X &&
-						MovementTile->GetGridPosition().Y == ClickedTile->GetGridPosition().Y)
-					{
-						MatchedTile = MovementTile;
-						break;
-					}
-				}
+				// Constant time check against the area already computed for the highlight
+				ATile* MatchedTile = SelectedUnit->CanMoveToTile(ClickedTile) ? ClickedTile : nullptr;
 
 				if (MatchedTile)
 				{
@@ -344,8 +322,8 @@ void ATBS_HumanPlayer::OnClick()
 						if (GameModeRef)
 						{
 							GameModeRef->RecordMove(PlayerNumber,
-								SelectedUnit->GetUnitName(),
-								TEXT("Move"), FromPos, ToPos, 0);
+								SelectedUnit,
+								ETBSLogAction::Move, FromPos, ToPos);
 						}
 
 						ClearHighlightedTiles();
@@ -392,8 +370,8 @@ void ATBS_HumanPlayer::OnClick()
 					if (GameModeRef)
 					{
 						GameModeRef->RecordMove(PlayerNumber,
-							SelectedUnit->GetUnitName(),
-							TEXT("Attack"), FromPos, TargetPos, Damage);
+							SelectedUnit,
+							ETBSLogAction::Attack, FromPos, TargetPos, Damage);
 					}
 
 					if (GameInstance)
@@ -419,6 +397,8 @@ void ATBS_HumanPlayer::OnClick()
 			}
 			break;
 		}
+
+		RefreshSelectionMessage();
 	}
 }
 
@@ -447,6 +427,8 @@ void ATBS_HumanPlayer::OnRightClick()
 
 		ClearHighlightedTiles();
 	}
+
+	RefreshSelectionMessage();
 }
 
 
@@ -470,6 +452,8 @@ void ATBS_HumanPlayer::SkipUnitTurn()
 
 		// Check if all units have completed their actions
 		CheckAllUnitsFinished();
+
+		RefreshSelectionMessage();
 	}
 }
 
@@ -477,6 +461,7 @@ void ATBS_HumanPlayer::ResetActionState()
 {
 	CurrentAction = EPlayerAction::NONE;
 	ClearCurrentPlacementTile();
+	RefreshSelectionMessage();
 }
 
 void ATBS_HumanPlayer::CheckAllUnitsFinished()
@@ -540,6 +525,8 @@ void ATBS_HumanPlayer::SetTurnState_Implementation(bool bNewTurnState)
 			GameMode->ShowEndTurnButton(false);
 		}
 	}
+
+	RefreshSelectionMessage();
 }
 
 void ATBS_HumanPlayer::UpdateUI_Implementation()
@@ -582,68 +569,65 @@ void ATBS_HumanPlayer::UpdateUI_Implementation()
 
 void ATBS_HumanPlayer::HighlightMovementTiles()
 {
-	// Clear any previous highlights
-	ClearHighlightedTiles();
+	AGrid* Grid = GetGrid();
 
-	if (!SelectedUnit)
+	if (!SelectedUnit || !Grid)
 	{
+		ClearHighlightedTiles();
 		return;
 	}
 
 	if (SelectedUnit->HasMoved())
 	{
+		ClearHighlightedTiles();
 		return;
 	}
 
-	TArray<ATile*> HighlightedMovementTilesBeta;
-
-	// Get and highlight movement tiles
-	HighlightedMovementTilesBeta = SelectedUnit->GetMovementTiles();
-
-	for (int32 i = 0; i <= HighlightedMovementTilesBeta.Num() - 1; i++)
+	// Get the movement tiles
+	HighlightedMovementTiles.Reset();
+	for (ATile* Tile : SelectedUnit->GetMovementTiles())
 	{
-		ATile* Tile = HighlightedMovementTilesBeta[i];
 		if (!Tile->IsObstacle())
 		{
 			HighlightedMovementTiles.Add(Tile);
 		}
 	}
+	HighlightedAttackTiles.Reset();
 
-	// Apply the highlight material to each tile
-	for (ATile* Tile : HighlightedMovementTiles)
-	{
-		if (Tile)
-		{
-			Tile->SetHighlightForMovement();
-		}
-
-	}
+	// The grid only redraws the tiles whose highlight changes
+	Grid->ClearHighlightedCells(ETileVisual::ATTACK);
+	Grid->SetHighlightedTiles(ETileVisual::MOVEMENT, HighlightedMovementTiles);
 
 	CurrentAction = EPlayerAction::MOVEMENT;
+	RefreshSelectionMessage();
 }
 
 void ATBS_HumanPlayer::HighlightAttackTiles()
 {
-	// Clear any previous highlights
-	ClearHighlightedTiles();
+	AGrid* Grid = GetGrid();
 
 	// Ensure a unit is selected and can attack
-	if (!SelectedUnit)
+	if (!SelectedUnit || !Grid)
 	{
+		ClearHighlightedTiles();
 		return;
 	}
 
 	if (SelectedUnit->HasAttacked())
 	{
+		ClearHighlightedTiles();
 		return;
 	}
 
-	// Get and highlight attack tiles
-	HighlightedAttackTiles = SelectedUnit->GetAttackTiles();
+	// Get the attack tiles
+	TArray<ATile*> AttackTiles = SelectedUnit->GetAttackTiles();
 
 	// Check if there are no attackable tiles
-	if (HighlightedAttackTiles.Num() == 0)
+	if (AttackTiles.Num() == 0)
 	{
+		// Clear any previous highlights
+		ClearHighlightedTiles();
+
 		// Update the turn message to inform the player
 		if (GameInstance)
 		{
@@ -663,39 +647,27 @@ void ATBS_HumanPlayer::HighlightAttackTiles()
 		}
 
 		// Don't set attack mode if there are no targets
-		CurrentAction = EPlayerAction::NONE;
 		return;
 	}
 
-	// Apply the highlight material to each tile
-	for (ATile* Tile : HighlightedAttackTiles)
-	{
-		if (Tile)
-		{
-			Tile->SetHighlightForAttack();
-		}
-	}
+	HighlightedAttackTiles = MoveTemp(AttackTiles);
+	HighlightedMovementTiles.Reset();
+
+	// The grid only redraws the tiles whose highlight changes
+	Grid->ClearHighlightedCells(ETileVisual::MOVEMENT);
+	Grid->SetHighlightedTiles(ETileVisual::ATTACK, HighlightedAttackTiles);
 
 	CurrentAction = EPlayerAction::ATTACK;
+	RefreshSelectionMessage();
 }
 
 void ATBS_HumanPlayer::ClearHighlightedTiles()
 {
-	// Clear visual highlights from all tiles
-	for (ATile* Tile : HighlightedMovementTiles)
+	// Clear the highlights in one batch per layer
+	if (AGrid* Grid = GetGrid())
 	{
-		if (Tile)
-		{
-			Tile->ClearHighlight();
-		}
-	}
-
-	for (ATile* Tile : HighlightedAttackTiles)
-	{
-		if (Tile)
-		{
-			Tile->ClearHighlight();
-		}
+		Grid->ClearHighlightedCells(ETileVisual::MOVEMENT);
+		Grid->ClearHighlightedCells(ETileVisual::ATTACK);
 	}
 
 	// Clear arrays
@@ -704,9 +676,21 @@ void ATBS_HumanPlayer::ClearHighlightedTiles()
 
 	// Reset mode
 	CurrentAction = EPlayerAction::NONE;
+	RefreshSelectionMessage();
+}
+
+AGrid* ATBS_HumanPlayer::GetGrid() const
+{
+	ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+	return GameMode ? GameMode->GameGrid : nullptr;
 }
 
 FString ATBS_HumanPlayer::GetSelectionMessage() const
+{
+	return SelectionMessage;
+}
+
+FString ATBS_HumanPlayer::BuildSelectionMessage() const
 {
 	// Handle different scenarios
 	if (!IsMyTurn)
@@ -797,6 +781,29 @@ void ATBS_HumanPlayer::ForceEndTurn()
 	ClearHighlightedTiles();
 }
 
+void ATBS_HumanPlayer::RefreshSelectionMessage()
+{
+	FString Message = BuildSelectionMessage();
+	if (Message.Equals(SelectionMessage, ESearchCase::CaseSensitive))
+	{
+		return;
+	}
+
+	SelectionMessage = MoveTemp(Message);
+	OnSelectionMessageChanged.Broadcast(SelectionMessage);
+}
+
+void ATBS_HumanPlayer::SetLastClickedUnit(AUnit* Unit)
+{
+	if (LastClickedUnit == Unit)
+	{
+		return;
+	}
+
+	LastClickedUnit = Unit;
+	OnLastClickedUnitChanged.Broadcast(LastClickedUnit);
+}
+
 void ATBS_HumanPlayer::PlaceUnit(int32 GridX, int32 GridY, EUnitType Type)
 {
 	// Implementation would connect to GameMode's PlaceUnit function
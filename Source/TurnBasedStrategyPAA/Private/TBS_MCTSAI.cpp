@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TBS_MCTSAI.h"
+#include "TBSRandom.h"
+
+ATBS_MCTSAI::ATBS_MCTSAI()
+{
+    MonteCarloTimeBudget = 1.0f;
+    NumTrees = 0;
+    Exploration = 0.7f;
+    RolloutTurns = 4;
+}
+
+void ATBS_MCTSAI::LaunchSearch(const FTBSGameState& State)
+{
+    FTBSMonteCarloSettings Settings;
+    Settings.TimeBudget = MonteCarloTimeBudget;
+    Settings.NumTrees = NumTrees;
+    Settings.Exploration = Exploration;
+    Settings.RolloutTurns = RolloutTurns;
+    Settings.Seed = GetRandom().RandRange(0, MAX_int32 - 1);
+
+    Planner->Start(State, Settings);
+}
@@ -8,6 +8,7 @@
 #include "EngineUtils.h"
 #include "Sniper.h"
 #include "Brawler.h"
+#include "TBSStats.h"
 
 // Sets default values
 ATBS_NaiveAI::ATBS_NaiveAI()
@@ -154,17 +155,11 @@ void ATBS_NaiveAI::FindMyUnits()
 {
 	MyUnits.Empty();
 
-	// Find all units of this player
-	TArray<AActor*> AllUnits;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
-
-	for (AActor* Actor : AllUnits)
+	// Units of this player, straight from the game mode's registry
+	ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode)
 	{
-		AUnit* Unit = Cast<AUnit>(Actor);
-		if (Unit && Unit->GetOwnerID() == PlayerNumber)
-		{
-			MyUnits.Add(Unit);
-		}
+		MyUnits = GameMode->GetPlayerUnits(PlayerNumber);
 	}
 }
 
@@ -213,7 +208,7 @@ void ATBS_NaiveAI::ProcessPlacementAction()
 	for (int32 Attempt = 0; Attempt < MaxPlacementAttempts && !Success; Attempt++)
 	{
 		// Randomly select from available unit types
-		int32 RandomIndex = FMath::RandRange(0, AvailableTypes.Num() - 1);
+		int32 RandomIndex = GetRandom().RandRange(0, AvailableTypes.Num() - 1);
 		EUnitType TypeToPlace = AvailableTypes[RandomIndex];
 
 		// Find random empty tile to place the unit
@@ -240,32 +235,26 @@ void ATBS_NaiveAI::ProcessPlacementAction()
 		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red,
 			TEXT("AI Placement - Failed after multiple attempts! Emergency handling..."));
 
-		// Find ANY valid tile on the grid
-		for (ATile* Tile : Grid->TileArray)
+		// Find ANY valid tile on the grid, read from the cells: an instanced board has no tile actor per cell
+		TArray<int32> FreeCells;
+		Grid->GetWalkableBits().ForEachSetBit([&FreeCells](const int32 Index)
+			{
+				FreeCells.Add(Index);
+			});
+
+		for (const int32 Index : FreeCells)
 		{
-			if (Tile && Tile->GetTileStatus() == ETileStatus::EMPTY && Tile->GetOwner() != -2)
+			const FIntPoint Cell = Grid->GetCellCoords(Index);
+
+			// Try placing with the first available unit type
+			EUnitType TypeToPlace = AvailableTypes[0];
+			Success = GameMode->PlaceUnit(TypeToPlace, Cell.X, Cell.Y, PlayerNumber);
+
+			if (Success)
 			{
-				FVector2D GridPos = Tile->GetGridPosition();
-				int32 GridX = GridPos.X;
-				int32 GridY = GridPos.Y;
-
-				// Try placing with the first available unit type
-				EUnitType TypeToPlace = AvailableTypes[0];
-				Success = GameMode->PlaceUnit(TypeToPlace, GridX, GridY, PlayerNumber);
-
-				if (Success)
-				{
-					FString UnitTypeString = (TypeToPlace == EUnitType::BRAWLER) ? "Brawler" : "Sniper";
-					if (GameInstance)
-					{
-						GameInstance->AddMoveToHistory(PlayerNumber, UnitTypeString, "Place",
-							FVector2D::ZeroVector, FVector2D(GridX, GridY), 0);
-					}
-
-					GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green,
-						TEXT("AI Placement - Emergency placement successful!"));
-					break;
-				}
+				GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green,
+					TEXT("AI Placement - Emergency placement successful!"));
+				break;
 			}
 		}
 	}
@@ -291,6 +280,13 @@ void ATBS_NaiveAI::ProcessPlacementAction()
 	bIsProcessingTurn = false;
 }
 
+FTBSRandom& ATBS_NaiveAI::GetRandom() const
+{
+	ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+	check(GameMode);
+	return GameMode->GetMatchRandom().GetAI(PlayerNumber);
+}
+
 bool ATBS_NaiveAI::PickRandomTileForPlacement(int32& OutX, int32& OutY)
 {
 	if (!Grid)
@@ -299,70 +295,21 @@ bool ATBS_NaiveAI::PickRandomTileForPlacement(int32& OutX, int32& OutY)
 		return false;
 	}
 
-	// Create a list of all empty tiles with additional verification
-	TArray<ATile*> EmptyTiles;
-	int32 totalTiles = 0;
-	int32 occupiedTiles = 0;
-	int32 obstacleTiles = 0;
-	int32 emptyTiles = 0;
-
-	for (ATile* Tile : Grid->TileArray)
-	{
-		totalTiles++;
-
-		if (!Tile)
-			continue;
-
-		ETileStatus status = Tile->GetTileStatus();
-		int32 owner = Tile->GetOwner();
-
-		if (status == ETileStatus::EMPTY)
+	// Free cells straight from the walkable bitboard, no tile actor is needed
+	TArray<int32> EmptyCells;
+	Grid->GetWalkableBits().ForEachSetBit([&EmptyCells](const int32 Index)
 		{
-			// Double-check it's truly empty
-			if (!Tile->GetOccupyingUnit() && owner != -2) // -2 is for obstacles
-			{
-				EmptyTiles.Add(Tile);
-				emptyTiles++;
-			}
-			else if (owner == -2)
-			{
-				obstacleTiles++;
-			}
-		}
-		else
-		{
-			occupiedTiles++;
-		}
-	}
+			EmptyCells.Add(Index);
+		});
 
-	// If we found empty tiles, pick a random one
-	if (EmptyTiles.Num() > 0)
+	// Pick random empty tile
+	if (EmptyCells.Num() > 0)
 	{
-		int32 MaxAttempts = 10; // Prevent infinite loop
-		for (int32 Attempt = 0; Attempt < MaxAttempts; Attempt++)
-		{
-			int32 RandomIndex = FMath::RandRange(0, EmptyTiles.Num() - 1);
-			ATile* SelectedTile = EmptyTiles[RandomIndex];
-
-			// Final verification that tile is truly empty
-			if (SelectedTile && SelectedTile->GetTileStatus() == ETileStatus::EMPTY &&
-				!SelectedTile->GetOccupyingUnit() && SelectedTile->GetOwner() != -2)
-			{
-				FVector2D GridPos = SelectedTile->GetGridPosition();
-				OutX = GridPos.X;
-				OutY = GridPos.Y;
+		const FIntPoint Cell = Grid->GetCellCoords(EmptyCells[GetRandom().RandRange(0, EmptyCells.Num() - 1)]);
+		OutX = Cell.X;
+		OutY = Cell.Y;
 
-				return true;
-			}
-			else
-			{
-				// Remove this tile from consideration and try again
-				EmptyTiles.RemoveAt(RandomIndex);
-
-				if (EmptyTiles.Num() == 0)
-					break;
-			}
-		}
+		return true;
 	}
 
 	GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("AI - Could not find any suitable empty tiles after verification"));
@@ -386,7 +333,7 @@ void ATBS_NaiveAI::ProcessTurnAction()
 	while (UnitsToProcess.Num() > 0)
 	{
 		// Picks a random unit to process
-		int32 RandomIndex = FMath::RandRange(0, UnitsToProcess.Num() - 1);
+		int32 RandomIndex = GetRandom().RandRange(0, UnitsToProcess.Num() - 1);
 		AUnit* UnitToProcess = UnitsToProcess[RandomIndex];
 
 		// Process the unit's action
@@ -402,15 +349,14 @@ void ATBS_NaiveAI::ProcessTurnAction()
 
 void ATBS_NaiveAI::ProcessUnitAction(AUnit* Unit)
 {
-	// Find all units owned by this AI
-	FindMyUnits();
+	TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_AIUnitAction);
 
 	if (!Unit || Unit->IsDead())
 		return;
 
 	// First, try to attack (50% chance)
 	bool HasAttacked = false;
-	if (FMath::RandBool())
+	if (GetRandom().RandBool())
 	{
 		HasAttacked = TryAttackWithUnit(Unit);
 	}
@@ -435,7 +381,10 @@ void ATBS_NaiveAI::ProcessUnitAction(AUnit* Unit)
 		Unit->bHasAttacked = true;
 
 		// Record skipped turn
-		GameInstance->AddMoveToHistory(PlayerNumber, Unit->GetUnitName(), "Skip", FVector2D::ZeroVector, FVector2D::ZeroVector, 0);
+		if (ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode()))
+		{
+			GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Skip, FVector2D::ZeroVector, FVector2D::ZeroVector);
+		}
 	}
 }
 
@@ -452,7 +401,7 @@ bool ATBS_NaiveAI::TryMoveUnit(AUnit* Unit)
 		return false;
 
 	// Pick a random tile to move to
-	int32 RandomIndex = FMath::RandRange(0, MovementTiles.Num() - 1);
+	int32 RandomIndex = GetRandom().RandRange(0, MovementTiles.Num() - 1);
 	ATile* TargetTile = MovementTiles[RandomIndex];
 
 	// Record the initial position
@@ -468,7 +417,7 @@ bool ATBS_NaiveAI::TryMoveUnit(AUnit* Unit)
 		ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
 		if (GameMode)
 		{
-			GameMode->RecordMove(PlayerNumber, Unit->GetUnitName(), "Move", FromPosition, ToPosition, 0);
+			GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Move, FromPosition, ToPosition);
 		}
 	}
 
@@ -488,7 +437,7 @@ bool ATBS_NaiveAI::TryAttackWithUnit(AUnit* Unit)
 		return false;
 
 	// Pick a random tile to attack
-	int32 RandomIndex = FMath::RandRange(0, AttackTiles.Num() - 1);
+	int32 RandomIndex = GetRandom().RandRange(0, AttackTiles.Num() - 1);
 	ATile* TargetTile = AttackTiles[RandomIndex];
 
 	// Get the unit on the target tile
@@ -507,7 +456,7 @@ bool ATBS_NaiveAI::TryAttackWithUnit(AUnit* Unit)
 	ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
 	if (GameMode)
 	{
-		GameMode->RecordMove(PlayerNumber, Unit->GetUnitName(), "Attack", FromPosition, ToPosition, Damage);
+		GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Attack, FromPosition, ToPosition, Damage);
 	}
 
 	return true;
@@ -523,9 +472,9 @@ void ATBS_NaiveAI::SkipUnitTurn()
 		SelectedUnit->bHasAttacked = true;
 
 		// Record skipped turn in move history
-		if (GameInstance)
+		if (ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode()))
 		{
-			GameInstance->AddMoveToHistory(PlayerNumber, SelectedUnit->GetUnitName(), "Skip", FVector2D::ZeroVector, FVector2D::ZeroVector, 0);
+			GameMode->RecordMove(PlayerNumber, SelectedUnit, ETBSLogAction::Skip, FVector2D::ZeroVector, FVector2D::ZeroVector);
 		}
 
 		// Clear the selected unit
@@ -3,7 +3,6 @@
 #include "TBS_PlayerController.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
-#include "Kismet/GameplayStatics.h"
 #include "TBS_HumanPlayer.h"
 #include "TBS_GameInstance.h"
 
@@ -54,49 +53,11 @@ void ATBS_PlayerController::SetGameInputMode()
 
 void ATBS_PlayerController::ClickOnGrid()
 {
-    // Get hit results for all objects
-    FHitResult HitResult;
-    bool bHitSuccessful = GetHitResultUnderCursor(ECC_Visibility, false, HitResult);
-
-    if (bHitSuccessful)
+    // The human player picks the clicked cell from the cursor ray, no tile search here
+    ATBS_HumanPlayer* HumanPlayer = Cast<ATBS_HumanPlayer>(GetPawn());
+    if (HumanPlayer)
     {
-        // Try to cast to tile first
-        ATile* ClickedTile = Cast<ATile>(HitResult.GetActor());
-
-        // If no tile found, try to find the closest tile
-        if (!ClickedTile)
-        {
-            TArray<AActor*> FoundTiles;
-            UGameplayStatics::GetAllActorsOfClass(GetWorld(), ATile::StaticClass(), FoundTiles);
-
-            float ClosestDistance = FLT_MAX;
-            for (AActor* TileActor : FoundTiles)
-            {
-                ATile* Tile = Cast<ATile>(TileActor);
-                if (Tile)
-                {
-                    float Distance = FVector::Distance(HitResult.Location, Tile->GetActorLocation());
-                    if (Distance < ClosestDistance)
-                    {
-                        ClosestDistance = Distance;
-                        ClickedTile = Tile;
-                    }
-                }
-            }
-        }
-
-        // If we found a tile, pass it to the human player
-        if (ClickedTile)
-        {
-            APawn* ControlledPawn = GetPawn();
-            ATBS_HumanPlayer* HumanPlayer = Cast<ATBS_HumanPlayer>(ControlledPawn);
-
-            if (HumanPlayer)
-            {
-                // Use the tile we found
-                HumanPlayer->OnClick();
-            }
-        }
+        HumanPlayer->OnClick();
     }
 }
 
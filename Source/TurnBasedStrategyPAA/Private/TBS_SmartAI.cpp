@@ -8,6 +8,8 @@
 #include "EngineUtils.h"
 #include "Sniper.h"
 #include "Brawler.h"
+#include "TBSCombatTables.h"
+#include "TBSStats.h"
 
 // Sets default values
 ATBS_SmartAI::ATBS_SmartAI()
@@ -26,6 +28,12 @@ ATBS_SmartAI::ATBS_SmartAI()
     UnitColor = EUnitColor::RED;
     CurrentAction = ESAIAction::NONE;
     SelectedUnit = nullptr;
+    bUseSearch = true;
+    SearchTimeBudget = 0.3f;
+    SearchMaxDepth = 12;
+    NextPlanAction = 0;
+    NumSearchesThisTurn = 0;
+    NextPendingUnit = 0;
 }
 
 // Called when the game starts or when spawned
@@ -45,6 +53,13 @@ void ATBS_SmartAI::BeginPlay()
     }
 }
 
+void ATBS_SmartAI::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    ResetActionState();
+
+    Super::EndPlay(EndPlayReason);
+}
+
 // Called every frame
 void ATBS_SmartAI::Tick(float DeltaTime)
 {
@@ -162,17 +177,11 @@ void ATBS_SmartAI::FindMyUnits()
 {
     MyUnits.Empty();
 
-    // Find all units of this player
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
-
-    for (AActor* Actor : AllUnits)
+    // Units of this player, straight from the game mode's registry
+    ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+    if (GameMode)
     {
-        AUnit* Unit = Cast<AUnit>(Actor);
-        if (Unit && Unit->GetOwnerID() == PlayerNumber && !Unit->IsDead())
-        {
-            MyUnits.Add(Unit);
-        }
+        MyUnits = GameMode->GetPlayerUnits(PlayerNumber);
     }
 }
 
@@ -180,17 +189,11 @@ void ATBS_SmartAI::FindEnemyUnits()
 {
     EnemyUnits.Empty();
 
-    // Find all units of the opponent
-    TArray<AActor*> AllUnits;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), AUnit::StaticClass(), AllUnits);
-
-    for (AActor* Actor : AllUnits)
+    // Units of the opponent, straight from the game mode's registry
+    ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+    if (GameMode)
     {
-        AUnit* Unit = Cast<AUnit>(Actor);
-        if (Unit && Unit->GetOwnerID() != PlayerNumber && !Unit->IsDead())
-        {
-            EnemyUnits.Add(Unit);
-        }
+        GameMode->GetEnemyUnits(PlayerNumber, EnemyUnits);
     }
 }
 
@@ -238,7 +241,7 @@ void ATBS_SmartAI::ProcessPlacementAction()
     for (int32 Attempt = 0; Attempt < MaxPlacementAttempts && !Success; Attempt++)
     {
         // Randomly select from available unit types
-        int32 RandomIndex = FMath::RandRange(0, AvailableTypes.Num() - 1);
+        int32 RandomIndex = GetRandom().RandRange(0, AvailableTypes.Num() - 1);
         EUnitType TypeToPlace = AvailableTypes[RandomIndex];
 
         // Find random empty tile to place the unit
@@ -271,32 +274,26 @@ void ATBS_SmartAI::ProcessPlacementAction()
         GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red,
             TEXT("Smart AI Placement - Failed after multiple attempts! Emergency handling..."));
 
-        // Find any valid tile on the grid
-        for (ATile* Tile : Grid->TileArray)
-        {
-            if (Tile && Tile->GetTileStatus() == ETileStatus::EMPTY && Tile->GetOwner() != -2)
+        // Find any valid tile on the grid, read from the cells: an instanced board has no tile actor per cell
+        TArray<int32> FreeCells;
+        Grid->GetWalkableBits().ForEachSetBit([&FreeCells](const int32 Index)
             {
-                FVector2D GridPos = Tile->GetGridPosition();
-                int32 GridX = GridPos.X;
-                int32 GridY = GridPos.Y;
+                FreeCells.Add(Index);
+            });
 
-                // Try placing with the first available unit type
-                EUnitType TypeToPlace = AvailableTypes[0];
-                Success = GameMode->PlaceUnit(TypeToPlace, GridX, GridY, PlayerNumber);
+        for (const int32 Index : FreeCells)
+        {
+            const FIntPoint Cell = Grid->GetCellCoords(Index);
 
-                if (Success)
-                {
-                    FString UnitTypeString = (TypeToPlace == EUnitType::BRAWLER) ? "Brawler" : "Sniper";
-                    if (GameInstance)
-                    {
-                        GameInstance->AddMoveToHistory(PlayerNumber, UnitTypeString, "Place",
-                            FVector2D::ZeroVector, FVector2D(GridX, GridY), 0);
-                    }
-
-                    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green,
-                        TEXT("Smart AI Placement - Emergency placement successful!"));
-                    break;
-                }
+            // Try placing with the first available unit type
+            EUnitType TypeToPlace = AvailableTypes[0];
+            Success = GameMode->PlaceUnit(TypeToPlace, Cell.X, Cell.Y, PlayerNumber);
+
+            if (Success)
+            {
+                GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Green,
+                    TEXT("Smart AI Placement - Emergency placement successful!"));
+                break;
             }
         }
     }
@@ -322,6 +319,13 @@ void ATBS_SmartAI::ProcessPlacementAction()
     bIsProcessingTurn = false;
 }
 
+FTBSRandom& ATBS_SmartAI::GetRandom() const
+{
+    ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+    check(GameMode);
+    return GameMode->GetMatchRandom().GetAI(PlayerNumber);
+}
+
 bool ATBS_SmartAI::PickRandomTileForPlacement(int32& OutX, int32& OutY)
 {
     if (!Grid)
@@ -330,76 +334,37 @@ bool ATBS_SmartAI::PickRandomTileForPlacement(int32& OutX, int32& OutY)
         return false;
     }
 
-    // Create a list of all empty tiles with additional verification
-    TArray<ATile*> EmptyTiles;
-    int32 totalTiles = 0;
-    int32 occupiedTiles = 0;
-    int32 obstacleTiles = 0;
-    int32 emptyTiles = 0;
-
-    for (ATile* Tile : Grid->TileArray)
-    {
-        totalTiles++;
-
-        if (!Tile)
-            continue;
-
-        ETileStatus status = Tile->GetTileStatus();
-        int32 owner = Tile->GetOwner();
-
-        if (status == ETileStatus::EMPTY)
+    // Free cells straight from the walkable bitboard, no tile actor is needed
+    TArray<int32> EmptyCells;
+    Grid->GetWalkableBits().ForEachSetBit([&EmptyCells](const int32 Index)
         {
-            // Double-check it's truly empty
-            if (!Tile->GetOccupyingUnit() && owner != -2) // -2 is for obstacles
-            {
-                EmptyTiles.Add(Tile);
-                emptyTiles++;
-            }
-            else if (owner == -2)
-            {
-                obstacleTiles++;
-            }
-        }
-        else
-        {
-            occupiedTiles++;
-        }
-    }
+            EmptyCells.Add(Index);
+        });
 
     // Pick random empty tile
-    if (EmptyTiles.Num() > 0)
+    if (EmptyCells.Num() > 0)
     {
-        int32 MaxAttempts = 10; // Prevent infinite loop
-        for (int32 Attempt = 0; Attempt < MaxAttempts; Attempt++)
-        {
-            int32 RandomIndex = FMath::RandRange(0, EmptyTiles.Num() - 1);
-            ATile* SelectedTile = EmptyTiles[RandomIndex];
+        const FIntPoint Cell = Grid->GetCellCoords(EmptyCells[GetRandom().RandRange(0, EmptyCells.Num() - 1)]);
+        OutX = Cell.X;
+        OutY = Cell.Y;
 
-            // Final verification that tile is truly empty
-            if (SelectedTile && SelectedTile->GetTileStatus() == ETileStatus::EMPTY &&
-                !SelectedTile->GetOccupyingUnit() && SelectedTile->GetOwner() != -2)
-            {
-                FVector2D GridPos = SelectedTile->GetGridPosition();
-                OutX = GridPos.X;
-                OutY = GridPos.Y;
-
-                return true;
-            }
-            else
-            {
-                // Remove this tile from consideration and try again
-                EmptyTiles.RemoveAt(RandomIndex);
-
-                if (EmptyTiles.Num() == 0)
-                    break;
-            }
-        }
+        return true;
     }
 
     GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Smart AI - Could not find any suitable empty tiles after verification"));
     return false;
 }
 
+// Searches planned per turn at most, a turn has a handful of actions
+static constexpr int32 MAX_SEARCHES_PER_TURN = 8;
+
+// Interval between two checks for the plan of the worker
+static constexpr float PLAN_POLL_INTERVAL = 0.05f;
+
+// Pause between two actions, so the player can follow them
+static constexpr float MIN_ACTION_PACING = 0.2f;
+static constexpr float MAX_ACTION_PACING = 0.5f;
+
 void ATBS_SmartAI::ProcessTurnAction()
 {
     // Find all units owned by this AI
@@ -413,26 +378,167 @@ void ATBS_SmartAI::ProcessTurnAction()
         return;
     }
 
-    // Process each unit with strategic thinking
-    for (AUnit* Unit : MyUnits)
+    if (bUseSearch)
+    {
+        NumSearchesThisTurn = 0;
+        StartPlanning();
+        return;
+    }
+
+    // Process each unit with strategic thinking, pausing between units with a timer
+    PendingUnits = MyUnits;
+    NextPendingUnit = 0;
+    ProcessNextUnit();
+}
+
+void ATBS_SmartAI::ProcessNextUnit()
+{
+    // Units killed in the meantime are skipped
+    while (PendingUnits.IsValidIndex(NextPendingUnit) &&
+        (!IsValid(PendingUnits[NextPendingUnit]) || PendingUnits[NextPendingUnit]->IsDead()))
+    {
+        NextPendingUnit++;
+    }
+
+    // End the turn after processing all units
+    if (!PendingUnits.IsValidIndex(NextPendingUnit))
+    {
+        FinishTurn();
+        return;
+    }
+
+    ProcessUnitAction(PendingUnits[NextPendingUnit++]);
+
+    float Delay = FMath::RandRange(MIN_ACTION_PACING, MAX_ACTION_PACING);
+    GetWorldTimerManager().SetTimer(ActionTimerHandle, this, &ATBS_SmartAI::ProcessNextUnit, Delay, false);
+}
+
+void ATBS_SmartAI::StartPlanning()
+{
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_AIPlanCapture);
+
+    ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+    if (!GameMode || !Grid || GameMode->bIsGameOver || NumSearchesThisTurn >= MAX_SEARCHES_PER_TURN ||
+        !GameMode->CaptureGameState(SearchState, SearchUnits) || SearchState.IsGameOver())
     {
-        if (Unit && !Unit->IsDead())
+        FinishTurn();
+        return;
+    }
+
+    NumSearchesThisTurn++;
+
+    if (!Planner.IsValid())
+    {
+        Planner = MakeShared<FTBSPlanner, ESPMode::ThreadSafe>();
+    }
+    LaunchSearch(SearchState);
+
+    // The game keeps running while the worker thinks
+    GetWorldTimerManager().SetTimer(ActionTimerHandle, this, &ATBS_SmartAI::PollPlan, PLAN_POLL_INTERVAL, true);
+}
+
+void ATBS_SmartAI::LaunchSearch(const FTBSGameState& State)
+{
+    FTBSSearchSettings Settings;
+    Settings.TimeBudget = SearchTimeBudget;
+    Settings.MaxDepth = SearchMaxDepth;
+
+    Planner->Start(State, Settings);
+}
+
+void ATBS_SmartAI::PollPlan()
+{
+    FTBSSearchResult Result;
+    if (!Planner.IsValid() || !Planner->TakeResult(Result))
+        return;
+
+    GetWorldTimerManager().ClearTimer(ActionTimerHandle);
+
+    PendingPlan = MoveTemp(Result.Plan);
+    NextPlanAction = 0;
+    ApplyNextPlannedAction();
+}
+
+void ATBS_SmartAI::ApplyNextPlannedAction()
+{
+    // The search horizon ended before the turn did: plan the rest
+    if (!PendingPlan.IsValidIndex(NextPlanAction))
+    {
+        StartPlanning();
+        return;
+    }
+
+    const FTBSAction Action = PendingPlan[NextPlanAction++];
+    if (Action.Type == ETBSActionType::EndTurn)
+    {
+        FinishTurn();
+        return;
+    }
+
+    // The board isn't what the plan expected anymore
+    if (!ApplySearchAction(Action))
+    {
+        StartPlanning();
+        return;
+    }
+
+    // The search assumed mean damage, after a real roll the rest of the turn is planned again
+    float Delay = FMath::RandRange(MIN_ACTION_PACING, MAX_ACTION_PACING);
+    if (Action.Type == ETBSActionType::Attack)
+    {
+        GetWorldTimerManager().SetTimer(ActionTimerHandle, this, &ATBS_SmartAI::StartPlanning, Delay, false);
+    }
+    else
+    {
+        GetWorldTimerManager().SetTimer(ActionTimerHandle, this, &ATBS_SmartAI::ApplyNextPlannedAction, Delay, false);
+    }
+}
+
+bool ATBS_SmartAI::ApplySearchAction(const FTBSAction& Action)
+{
+    AUnit* Unit = SearchUnits.IsValidIndex(Action.Unit) ? SearchUnits[Action.Unit] : nullptr;
+    if (!IsValid(Unit) || Unit->IsDead() || !Unit->GetCurrentTile())
+        return false;
+
+    ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
+    const FVector2D FromPosition = Unit->GetCurrentTile()->GetGridPosition();
+
+    if (Action.Type == ETBSActionType::Move)
+    {
+        ATile* TargetTile = Grid->GetTileByIndex(Action.Cell);
+        if (!TargetTile || !Unit->MoveToTile(TargetTile))
+            return false;
+
+        if (GameMode)
         {
-            // Process the unit's action with strategic thinking
-            ProcessUnitAction(Unit);
+            GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Move, FromPosition, TargetTile->GetGridPosition());
+        }
+        return true;
+    }
+
+    if (Action.Type == ETBSActionType::Attack)
+    {
+        AUnit* TargetUnit = SearchUnits.IsValidIndex(Action.Target) ? SearchUnits[Action.Target] : nullptr;
+        if (!IsValid(TargetUnit) || TargetUnit->IsDead() || Unit->HasAttacked() || !Unit->CanAttack(TargetUnit))
+            return false;
 
-            // Add a small delay between units
-            float Delay = FMath::RandRange(0.2f, 0.5f);
-            FPlatformProcess::Sleep(Delay);
+        const FVector2D ToPosition = TargetUnit->GetCurrentTile()->GetGridPosition();
+        const int32 Damage = Unit->Attack(TargetUnit);
+
+        if (GameMode)
+        {
+            GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Attack, FromPosition, ToPosition, Damage);
         }
+        return true;
     }
 
-    // End the turn after processing all units
-    FinishTurn();
+    return false;
 }
 
 void ATBS_SmartAI::ProcessUnitAction(AUnit* Unit)
 {
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_AIUnitAction);
+
     if (!Unit || Unit->IsDead())
         return;
 
@@ -463,9 +569,9 @@ void ATBS_SmartAI::ProcessUnitAction(AUnit* Unit)
         Unit->bHasAttacked = true;
 
         // Record skipped turn
-        if (GameInstance)
+        if (ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode()))
         {
-            GameInstance->AddMoveToHistory(PlayerNumber, Unit->GetUnitName(), "Skip", FVector2D::ZeroVector, FVector2D::ZeroVector, 0);
+            GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Skip, FVector2D::ZeroVector, FVector2D::ZeroVector);
         }
     }
 }
@@ -487,7 +593,7 @@ bool ATBS_SmartAI::TryMoveUnit(AUnit* Unit)
     if (!TargetTile)
     {
         // If no strategic tile found, pick a random one as fallback
-        int32 RandomIndex = FMath::RandRange(0, MovementTiles.Num() - 1);
+        int32 RandomIndex = GetRandom().RandRange(0, MovementTiles.Num() - 1);
         TargetTile = MovementTiles[RandomIndex];
     }
 
@@ -504,7 +610,7 @@ bool ATBS_SmartAI::TryMoveUnit(AUnit* Unit)
         ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
         if (GameMode)
         {
-            GameMode->RecordMove(PlayerNumber, Unit->GetUnitName(), "Move", FromPosition, ToPosition, 0);
+            GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Move, FromPosition, ToPosition);
         }
     }
 
@@ -544,7 +650,7 @@ bool ATBS_SmartAI::TryAttackWithUnit(AUnit* Unit)
     ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
     if (GameMode)
     {
-        GameMode->RecordMove(PlayerNumber, Unit->GetUnitName(), "Attack", FromPosition, ToPosition, Damage);
+        GameMode->RecordMove(PlayerNumber, Unit, ETBSLogAction::Attack, FromPosition, ToPosition, Damage);
     }
 
     return true;
@@ -580,9 +686,25 @@ AUnit* ATBS_SmartAI::SelectBestAttackTarget(AUnit* AttackingUnit, const TArray<A
         else
             Score += 25.0f;
 
-        // Consider if it can eliminate the unit (major strategic advantage)
-        if (AttackingUnit->GetAverageAttackDamage() >= TargetUnit->GetUnitHealth())
-            Score += 200.0f;
+        // Consider the odds of eliminating the unit (major strategic advantage)
+        const EUnitType AttackerType = AttackingUnit->GetUnitType();
+        float KillProbability;
+        if (FTBSCombatTables::IsTabulated(AttackerType, AttackingUnit->GetMinDamage(), AttackingUnit->GetMaxDamage()))
+            KillProbability = FTBSCombatTables::GetKillProbability(AttackerType, TargetUnit->GetUnitHealth());
+        else
+            KillProbability = (AttackingUnit->GetAverageAttackDamage() >= TargetUnit->GetUnitHealth()) ? 1.0f : 0.0f;
+        Score += KillProbability * 200.0f;
+
+        // Weigh the counter-damage the attacker takes, and the odds of it being fatal
+        const FVector2D AttackerPosition = AttackingUnit->GetCurrentTile()->GetGridPosition();
+        const FVector2D TargetPosition = Tile->GetGridPosition();
+        const int32 Distance = FMath::RoundToInt(FMath::Abs(AttackerPosition.X - TargetPosition.X) + FMath::Abs(AttackerPosition.Y - TargetPosition.Y));
+        if (FTBSCombatTables::HasCounterDamage(AttackerType, TargetUnit->GetUnitType(), Distance))
+        {
+            const int32 AttackerHealth = AttackingUnit->GetUnitHealth();
+            Score -= FTBSCombatTables::GetExpectedCounterDamage(AttackerHealth) / FMath::Max(1, AttackingUnit->GetMaxHealth()) * 100.0f;
+            Score -= FTBSCombatTables::GetCounterKillProbability(AttackerHealth) * 200.0f;
+        }
 
         // Update best target if score is higher
         if (Score > BestScore)
@@ -597,6 +719,10 @@ AUnit* ATBS_SmartAI::SelectBestAttackTarget(AUnit* AttackingUnit, const TArray<A
 
 void ATBS_SmartAI::FinishTurn()
 {
+    PendingPlan.Reset();
+    PendingUnits.Reset();
+    SearchUnits.Reset();
+
     // End our turn via the GameMode
     ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
     if (GameMode)
@@ -616,9 +742,9 @@ void ATBS_SmartAI::SkipUnitTurn()
         SelectedUnit->bHasAttacked = true;
 
         // Record skipped turn in move history
-        if (GameInstance)
+        if (ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode()))
         {
-            GameInstance->AddMoveToHistory(PlayerNumber, SelectedUnit->GetUnitName(), "Skip", FVector2D::ZeroVector, FVector2D::ZeroVector, 0);
+            GameMode->RecordMove(PlayerNumber, SelectedUnit, ETBSLogAction::Skip, FVector2D::ZeroVector, FVector2D::ZeroVector);
         }
 
         // Clear the selected unit
@@ -629,6 +755,17 @@ void ATBS_SmartAI::SkipUnitTurn()
 void ATBS_SmartAI::ResetActionState()
 {
     CurrentAction = ESAIAction::NONE;
+
+    // Abandon the turn being played, a late plan would act on a different board
+    GetWorldTimerManager().ClearTimer(ActionTimerHandle);
+    if (Planner.IsValid())
+    {
+        Planner->Cancel();
+    }
+
+    PendingPlan.Reset();
+    PendingUnits.Reset();
+    SearchUnits.Reset();
 }
 
 ATile* ATBS_SmartAI::SelectBestMovementDestination(AUnit* Unit)
@@ -706,6 +843,12 @@ ATile* ATBS_SmartAI::SelectBestMovementDestination(AUnit* Unit)
     }
     else // Brawler
     {
+        // Enemies out of reach: follow the shortest path around the obstacles instead of the straight line
+        if (ATile* ApproachTile = SelectApproachDestination(Unit))
+        {
+            return ApproachTile;
+        }
+
         // For Brawlers, aggresively approach enemies
         for (ATile* Tile : MovementTiles)
         {
@@ -763,4 +906,55 @@ ATile* ATBS_SmartAI::SelectBestMovementDestination(AUnit* Unit)
     }
 
     return BestTile;
+}
+
+ATile* ATBS_SmartAI::SelectApproachDestination(AUnit* Unit)
+{
+    ATile* StartTile = Unit ? Unit->GetCurrentTile() : nullptr;
+    if (!StartTile || !Grid || Unit->GetMovementRange() <= 0)
+        return nullptr;
+
+    FGridAStar& AStar = Grid->GetAStar();
+    const int32 StartIndex = StartTile->GetCellIndex();
+    const FVector2D StartPos = StartTile->GetGridPosition();
+
+    int32 BestLength = MAX_int32;
+
+    for (AUnit* Enemy : EnemyUnits)
+    {
+        if (!Enemy || Enemy->IsDead())
+            continue;
+
+        ATile* EnemyTile = Enemy->GetCurrentTile();
+        if (!EnemyTile)
+            continue;
+
+        // A path is never shorter than the Manhattan distance, skip enemies that can't beat the best one
+        if (CalculateHeuristic(StartPos, EnemyTile->GetGridPosition()) >= BestLength)
+            continue;
+
+        const int32 GoalIndex = EnemyTile->GetCellIndex();
+        const bool bFound = AStar.Run(StartIndex, GoalIndex, [this, GoalIndex](const int32 Index)
+            {
+                return Index == GoalIndex || Grid->IsCellWalkable(Index);
+            });
+
+        if (bFound && AStar.GetPathLength() < BestLength)
+        {
+            BestLength = AStar.GetPathLength();
+            AStar.GetPath(PathCells);
+        }
+    }
+
+    // No enemy reachable, or close enough to attack after this move: the regular scoring handles it
+    if (BestLength == MAX_int32 || BestLength - Unit->GetAttackRange() <= Unit->GetMovementRange())
+        return nullptr;
+
+    // Go as far as the movement allows along the path
+    return Grid->GetTileByIndex(PathCells[Unit->GetMovementRange() - 1]);
+}
+
+float ATBS_SmartAI::CalculateHeuristic(const FVector2D& Start, const FVector2D& Goal) const
+{
+    return FMath::Abs(Start.X - Goal.X) + FMath::Abs(Start.Y - Goal.Y);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 
 #include "Tile.h"
+#include "Grid.h"
 
 // Sets default values
 ATile::ATile()
@@ -32,12 +33,20 @@ ATile::ATile()
     OriginalMaterial = nullptr;
     bIsHighlighted = false;
     OccupyingUnit = nullptr;
+    Grid = nullptr;
+    CellIndex = INDEX_NONE;
 }
 
 void ATile::SetTileStatus(const int32 TileOwner, const ETileStatus TileStatus)
 {
     PlayerOwner = TileOwner;
     Status = TileStatus;
+
+    // The grid holds the authoritative copy of the board state
+    if (Grid)
+    {
+        Grid->UpdateCellStatus(CellIndex, TileOwner, TileStatus);
+    }
 }
 
 ETileStatus ATile::GetTileStatus()
@@ -60,9 +69,26 @@ FVector2D ATile::GetGridPosition()
     return TileGridPosition;
 }
 
+void ATile::BindToGrid(AGrid* InGrid, const int32 InCellIndex)
+{
+    Grid = InGrid;
+    CellIndex = InCellIndex;
+
+    if (Grid)
+    {
+        Grid->UpdateCellStatus(CellIndex, PlayerOwner, Status);
+        Grid->UpdateCellUnit(CellIndex, OccupyingUnit);
+    }
+}
+
 void ATile::SetOccupyingUnit(AUnit* Unit)
 {
     OccupyingUnit = Unit;
+
+    if (Grid)
+    {
+        Grid->UpdateCellUnit(CellIndex, Unit);
+    }
 }
 
 AUnit* ATile::GetOccupyingUnit()
@@ -72,80 +98,63 @@ AUnit* ATile::GetOccupyingUnit()
 
 void ATile::SetAsObstacle()
 {
-    // Set the tile status - owner -2 indicates obstacle
-    SetTileStatus(-2, ETileStatus::OCCUPIED);
-
-    // Ensure no unit is occupying this tile
-    if (OccupyingUnit)
-    {
-        OccupyingUnit = nullptr;
-    }
-
-    // Call the blueprint event to update the visual appearance
-    if (UFunction* Function = FindFunction(TEXT("SetObstacleMaterial")))
+    // The grid updates the tile state and its look together
+    if (Grid)
     {
-        ProcessEvent(Function, nullptr);
-    }
-    else
-    {
-        // Fallback if blueprint function doesn't exist
-        GEngine->AddOnScreenDebugMessage(-1, 3.f, FColor::Yellow,
-            TEXT("SetObstacleMaterial function not found in Blueprint"));
+        Grid->SetCellObstacle(CellIndex, true);
     }
 }
 
 void ATile::SetHighlightForMovement()
 {
-    // Never highlight obstacle tiles
-    if (IsObstacle() || GetOwner() == -2 ||
-        (GetTileStatus() == ETileStatus::OCCUPIED && !GetOccupyingUnit()))
-    {
-        return;
-    }
-
-    // Store the original material the first time we highlight
-    if (!OriginalMaterial && StaticMeshComponent)
-    {
-        OriginalMaterial = StaticMeshComponent->GetMaterial(0);
-    }
-
-    // Call the blueprint event to update the visual appearance
-    if (UFunction* Function = FindFunction(TEXT("HighlightForMovement")))
+    // The grid keeps the highlight layers, obstacle tiles are never highlighted
+    if (Grid)
     {
-        ProcessEvent(Function, nullptr);
-        bIsHighlighted = true;
+        Grid->SetCellHighlight(CellIndex, ETileVisual::MOVEMENT, true);
     }
 }
 
 void ATile::SetHighlightForAttack()
 {
-    // Never highlight obstacle tiles
-    if (IsObstacle() || GetOwner() == -2 ||
-        (GetTileStatus() == ETileStatus::OCCUPIED && !GetOccupyingUnit()))
+    if (Grid)
     {
-        return;
+        Grid->SetCellHighlight(CellIndex, ETileVisual::ATTACK, true);
     }
+}
 
-    // Store the original material the first time we highlight
-    if (!OriginalMaterial && StaticMeshComponent)
+void ATile::SetHighlightForSelection()
+{
+    if (Grid)
     {
-        OriginalMaterial = StaticMeshComponent->GetMaterial(0);
+        Grid->SetCellHighlight(CellIndex, ETileVisual::SELECTION, true);
     }
+}
 
-    // Call the blueprint event to update the visual appearance
-    if (UFunction* Function = FindFunction(TEXT("HighlightForAttack")))
+void ATile::ClearHighlight()
+{
+    if (Grid)
     {
-        ProcessEvent(Function, nullptr);
-        bIsHighlighted = true;
+        Grid->ClearCellHighlights(CellIndex);
     }
 }
 
-void ATile::SetHighlightForSelection()
+void ATile::DrawHighlight(const ETileVisual Visual)
 {
-    // Never highlight obstacle tiles
-    if (IsObstacle() || GetOwner() == -2 ||
-        (GetTileStatus() == ETileStatus::OCCUPIED && !GetOccupyingUnit()))
+    if (Visual == ETileVisual::GROUND)
     {
+        bIsHighlighted = false;
+
+        // If this is an obstacle tile, don't reset its material
+        if (Status == ETileStatus::OCCUPIED && PlayerOwner == -2)
+        {
+            return;
+        }
+
+        // For non-obstacle tiles, restore the original material
+        if (StaticMeshComponent && OriginalMaterial)
+        {
+            StaticMeshComponent->SetMaterial(0, OriginalMaterial);
+        }
         return;
     }
 
@@ -155,32 +164,14 @@ void ATile::SetHighlightForSelection()
         OriginalMaterial = StaticMeshComponent->GetMaterial(0);
     }
 
-    // Call the blueprint event to update the visual appearance
-    if (UFunction* Function = FindFunction(TEXT("HighlightForSelection")))
+    // Call the blueprint event to update the visual appearance, looked up once per tile class
+    if (UFunction* Function = Grid ? Grid->GetTileHighlightEvent(Visual) : nullptr)
     {
         ProcessEvent(Function, nullptr);
         bIsHighlighted = true;
     }
 }
 
-void ATile::ClearHighlight()
-{
-    // If this is an obstacle tile, don't reset its material
-    if (Status == ETileStatus::OCCUPIED && PlayerOwner == -2)
-    {
-        // Just remove the highlight state without changing the material
-        bIsHighlighted = false;
-        return;
-    }
-
-    // For non-obstacle tiles, restore the original material
-    if (StaticMeshComponent && OriginalMaterial)
-    {
-        StaticMeshComponent->SetMaterial(0, OriginalMaterial);
-        bIsHighlighted = false;
-    }
-}
-
 bool ATile::IsObstacle() const
 {
     // A tile is an obstacle if and only if its owner is -2
@@ -204,7 +195,7 @@ void ATile::BeginPlay()
         if (Status != ETileStatus::OCCUPIED)
         {
             // Correct the status
-            Status = ETileStatus::OCCUPIED;
+            SetTileStatus(PlayerOwner, ETileStatus::OCCUPIED);
         }
 
         // Ensure obstacle has its proper visual appearance
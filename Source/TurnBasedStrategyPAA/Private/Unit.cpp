@@ -4,6 +4,7 @@
 #include "Unit.h"
 #include "Grid.h"
 #include "TBS_GameMode.h"
+#include "TBSStats.h"
 #include "Kismet/GameplayStatics.h"
 
 // Sets default values
@@ -30,6 +31,8 @@ AUnit::AUnit()
     bHasMoved = false;
     bHasAttacked = false;
     CurrentTile = nullptr;
+    RegistryIndex = INDEX_NONE;
+    LastCounterDamage = 0;
 
 }
 
@@ -42,6 +45,9 @@ void AUnit::BeginPlay()
 {
     Super::BeginPlay();
 
+    // Health is set by the subclass constructors and the editor, it only changes through ReceiveDamage afterwards
+    UpdateLiveHealthText();
+
     // Finds the grid in the world
     TArray<AActor*> FoundActors;
     UGameplayStatics::GetAllActorsOfClass(GetWorld(), AGrid::StaticClass(), FoundActors);
@@ -52,6 +58,19 @@ void AUnit::BeginPlay()
 
 }
 
+void AUnit::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (RegistryIndex != INDEX_NONE)
+    {
+        if (ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode()))
+        {
+            GameMode->UnregisterUnit(this);
+        }
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
 // Called every frame
 void AUnit::Tick(float DeltaTime)
 {
@@ -102,6 +121,11 @@ int32 AUnit::GetAttackRange() const
     return AttackRange;
 }
 
+int32 AUnit::GetMovementRange() const
+{
+    return MovementRange;
+}
+
 int32 AUnit::GetMinDamage() const
 {
     return MinDamage;
@@ -119,7 +143,12 @@ float AUnit::GetAverageAttackDamage() const
 
 FString AUnit::GetLiveHealth()
 {
-    return FString::Printf(TEXT("Hp: %d / %d"), Health, MaxHealth);
+    return LiveHealthText;
+}
+
+void AUnit::UpdateLiveHealthText()
+{
+    LiveHealthText = FString::Printf(TEXT("Hp: %d / %d"), Health, MaxHealth);
 }
 
 float AUnit::GethealthPercentage()
@@ -160,8 +189,7 @@ bool AUnit::MoveToTile(ATile* Tile)
     if (!Tile || bHasMoved) // Checks the possibility to move
         return false;
 
-    TArray<ATile*> ValidTiles = GetMovementTiles();
-    if (!ValidTiles.Contains(Tile))
+    if (!CanMoveToTile(Tile))
         return false;
 
     // Updates the old tile
@@ -183,154 +211,123 @@ bool AUnit::MoveToTile(ATile* Tile)
 // Checks possible tiles to occupy
 TArray<ATile*> AUnit::GetMovementTiles()
 {
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_MovementTiles);
+
     TArray<ATile*> ValidTiles;
     if (!CurrentTile || !Grid)
         return ValidTiles;
 
-    // Validate obstacles before calculating movement
-    Grid->ValidateAllObstacles();
-
-    // Algorithm BFS to find valid movement tiles
-    TArray<ATile*> Queue;
-    TMap<ATile*, int32> Distance;
-
-    Queue.Add(CurrentTile);
-    Distance.Add(CurrentTile, 0);
+    // Cells within walking distance, computed once per board version
+    const int32 StartIndex = CurrentTile->GetCellIndex();
+    const FGridDistanceField& Field = *GetMovementField();
 
-    while (Queue.Num() > 0)
+    // Every reached cell but the starting one is a valid destination
+    ValidTiles.Reserve(Field.Cells.Num() - 1);
+    for (const int32 Index : Field.Cells)
     {
-        ATile* Tile = Queue[0];
-        Queue.RemoveAt(0);
-
-        // Skip null tiles
-        if (!Tile)
-            continue;
-
-        FVector2D TilePos = Tile->GetGridPosition();
-        int32 CurrentDistance = Distance[Tile];
-
-        // If this isn't the current tile and it's a valid destination, add it to valid tiles
-        // Explicitly check that it's not an obstacle in multiple ways
-        if (Tile != CurrentTile &&
-            Tile->GetTileStatus() == ETileStatus::EMPTY &&
-            !Tile->IsObstacle() &&
-            Tile->GetOwner() != -2 &&
-            !Tile->GetOccupyingUnit())
+        if (Index != StartIndex)
         {
-            ValidTiles.Add(Tile);
-        }
-
-        // Only explore further if within movement range
-        if (CurrentDistance < MovementRange)
-        {
-            // Explicitly use only 4 cardinal directions for movement
-            TArray<FVector2D> Directions = {
-                FVector2D(0, 1),   // Up
-                FVector2D(0, -1),  // Down
-                FVector2D(1, 0),   // Right
-                FVector2D(-1, 0)   // Left
-            };
-
-            for (const FVector2D& Dir : Directions)
-            {
-                FVector2D NewPos = TilePos + Dir;
-
-                // Check if the position is within grid bounds
-                if (!Grid->TileMap.Contains(NewPos))
-                    continue;
-
-                ATile* NextTile = Grid->TileMap[NewPos];
-
-                // Skip if null, already processed, or is an obstacle
-                if (!NextTile || Distance.Contains(NextTile))
-                    continue;
-
-                // Skip obstacles - multiple checks for robustness
-                if (NextTile->IsObstacle() || NextTile->GetOwner() == -2)
-                    continue;
-
-                // Skip occupied tiles
-                if (NextTile->GetTileStatus() != ETileStatus::EMPTY || NextTile->GetOccupyingUnit())
-                    continue;
-
-                // This is a valid tile to explore
-                Queue.Add(NextTile);
-                Distance.Add(NextTile, CurrentDistance + 1);
-            }
+            ValidTiles.Add(Grid->GetTileByIndex(Index));
         }
     }
 
+    TBS_COUNTER_ADD(TBS_TileListsBuilt, 1);
+
     return ValidTiles;
 }
 
+bool AUnit::CanMoveToTile(ATile* Tile)
+{
+    const FGridDistanceField* Field = GetMovementField();
+    if (!Field || !Tile)
+        return false;
+
+    // Same answer as looking the tile up in GetMovementTiles
+    const int32 Index = Tile->GetCellIndex();
+    return Index != Field->SourceIndex && Index >= 0 && Index < Grid->GetNumCells() && Field->Contains(Index);
+}
+
+const FGridDistanceField* AUnit::GetMovementField()
+{
+    if (!CurrentTile || !Grid)
+        return nullptr;
+
+    // Any change of the board bumps its version, until then the last area still holds,
+    // unless other queries recycled its cache entry in the meantime
+    const int32 StartIndex = CurrentTile->GetCellIndex();
+    if (!MovementField || !MovementField->Matches(StartIndex, MovementRange, EGridQuery::Movement, Grid->GetBoardVersion()))
+    {
+        MovementField = &Grid->GetDistanceField(StartIndex, MovementRange, EGridQuery::Movement);
+    }
+
+    return MovementField;
+}
+
 TArray<ATile*> AUnit::GetAttackTiles()
 {
+    TBS_SCOPE_CYCLE_COUNTER(STAT_TBS_AttackTiles);
+
     TArray<ATile*> ValidTiles;
 
     if (!CurrentTile || !Grid)
         return ValidTiles;
 
-    // Algorithm BFS to find valid attack tiles
-    TArray<ATile*> Queue;
-    TMap<ATile*, int32> Distance;
-
-    Queue.Add(CurrentTile);
-    Distance.Add(CurrentTile, 0);
-
-    while (Queue.Num() > 0)
+    // Attacks go through obstacles, so the range is a plain Manhattan diamond:
+    // test the few units on the board instead of walking every cell of the diamond
+    const int32 StartIndex = CurrentTile->GetCellIndex();
+    for (AUnit* Unit : Grid->BoardUnits)
     {
-        ATile* Tile = Queue[0];
-        Queue.RemoveAt(0);
-
-        FVector2D TilePos = Tile->GetGridPosition();
-        int32 CurrentDistance = Distance[Tile];
-
-        // Checks if this is an attackable tile (if it is occupied by enemy)
-        // Note: Obstacles are not attackable even though they're "occupied"
-        if (Tile->GetTileStatus() == ETileStatus::OCCUPIED &&
-            Tile->GetOwner() != OwnerID &&
-            !Tile->IsObstacle() &&
-            Tile->GetOccupyingUnit())
+        const int32 Index = GetAttackableIndex(Unit);
+        if (Index != INDEX_NONE && Grid->GetCellDistance(StartIndex, Index) <= AttackRange)
         {
-            ValidTiles.Add(Tile);
-        }
-
-        // If still within attack range
-        if (CurrentDistance < AttackRange)
-        {
-            // Checks adjacent tiles (HASNEXT)
-            TArray<FVector2D> Directions = {
-                FVector2D(0, 1),
-                FVector2D(0, -1),
-                FVector2D(1, 0),
-                FVector2D(-1, 0)
-            };
-
-            // For every adjacent tile...
-            for (const FVector2D& Dir : Directions)
-            {
-                FVector2D NewPos = TilePos + Dir;
-
-                // ...checks if the new position is valid
-                if (Grid->TileMap.Contains(NewPos))
-                {
-                    ATile* NextTile = Grid->TileMap[NewPos];
-
-                    // If the tile hasn't been visited yet
-                    // Unlike movement tiles, attacks can go through obstacles in terms of range
-                    if (NextTile && !Distance.Contains(NextTile))
-                    {
-                        Queue.Add(NextTile);
-                        Distance.Add(NextTile, CurrentDistance + 1);
-                    }
-                }
-            }
+            ValidTiles.Add(Grid->GetTileByIndex(Index));
         }
     }
 
+    TBS_COUNTER_ADD(TBS_TileListsBuilt, 1);
+
     return ValidTiles;
 }
 
+int32 AUnit::GetAttackableIndex(AUnit* Unit) const
+{
+    if (!IsValid(Unit) || Unit == this || Unit->IsDead())
+        return INDEX_NONE;
+
+    ATile* UnitTile = Unit->GetCurrentTile();
+    if (!UnitTile)
+        return INDEX_NONE;
+
+    // The board must agree that the unit stands there, a dying unit may still point at its tile
+    const int32 Index = UnitTile->GetCellIndex();
+    if (Index < 0 || Index >= Grid->GetNumCells() || Grid->GetCellUnit(Index) != Unit || !IsAttackableCell(Index))
+        return INDEX_NONE;
+
+    return Index;
+}
+
+bool AUnit::IsAttackableCell(const int32 Index) const
+{
+    const FGridCell& Cell = Grid->GetCell(Index);
+
+    // Checks if this is an attackable tile (if it is occupied by enemy)
+    // Note: Obstacles are not attackable even though they're "occupied"
+    return Cell.Status == ETileStatus::OCCUPIED &&
+        Cell.Owner != OwnerID &&
+        !Cell.bObstacle &&
+        Cell.UnitSlot != INDEX_NONE;
+}
+
+bool AUnit::CanAttack(AUnit* TargetUnit)
+{
+    if (!CurrentTile || !Grid)
+        return false;
+
+    // Same answer as looking the target up in GetAttackTiles, without building the list
+    const int32 TargetIndex = GetAttackableIndex(TargetUnit);
+    return TargetIndex != INDEX_NONE && Grid->GetCellDistance(CurrentTile->GetCellIndex(), TargetIndex) <= AttackRange;
+}
+
 // Attack action
 int32 AUnit::Attack(AUnit* TargetUnit)
 {
@@ -338,12 +335,13 @@ int32 AUnit::Attack(AUnit* TargetUnit)
         return 0;
 
     // Checks if the target is within attack range
-    TArray<ATile*> ValidAttackTiles = GetAttackTiles();
-    if (!ValidAttackTiles.Contains(TargetUnit->GetCurrentTile()))
+    if (!CanAttack(TargetUnit))
         return 0;
 
+    LastCounterDamage = 0;
+
     // Calculates damage (random between min and max)
-    int32 Damage = FMath::RandRange(MinDamage, MaxDamage);
+    int32 Damage = RollDamage(MinDamage, MaxDamage);
 
     // Applies damage to target
     TargetUnit->ReceiveDamage(Damage);
@@ -352,12 +350,32 @@ int32 AUnit::Attack(AUnit* TargetUnit)
     return Damage;
 }
 
+int32 AUnit::RollDamage(int32 Min, int32 Max) const
+{
+    if (ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode()))
+    {
+        return GameMode->GetMatchRandom().GetCombat().RandRange(Min, Max);
+    }
+
+    // Outside of a match (e.g. a unit placed in the editor) nothing needs to replay
+    return FMath::RandRange(Min, Max);
+}
+
 // Reduces health based on damage received
 void AUnit::ReceiveDamage(int32 DamageAmount)
 {
+    const int32 OldHealth = Health;
+
     Health -= DamageAmount; // Reduces health keeping it within the limits
     Health = FMath::Max(0, FMath::Min(Health, MaxHealth));
 
+    // Listeners see the final value before a dying unit is destroyed
+    if (Health != OldHealth)
+    {
+        UpdateLiveHealthText();
+        OnHealthChanged.Broadcast(this, Health, MaxHealth);
+    }
+
     // If health reaches 0, unit dies
     if (Health <= 0)
     {
@@ -365,6 +383,9 @@ void AUnit::ReceiveDamage(int32 DamageAmount)
         ATBS_GameMode* GameMode = Cast<ATBS_GameMode>(GetWorld()->GetAuthGameMode());
         if (GameMode)
         {
+            // Leave the registry first so the counts are exact for the game over check
+            GameMode->UnregisterUnit(this);
+
             // Notify the game mode about which player's unit was destroyed
             GameMode->NotifyUnitDestroyed(OwnerID);
 
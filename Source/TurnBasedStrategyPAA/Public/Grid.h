@@ -4,25 +4,52 @@
 
 #include "CoreMinimal.h"
 #include "Tile.h"
+#include "GridBitboard.h"
+#include "GridBFS.h"
+#include "GridAStar.h"
+#include "GridDistanceCache.h"
 #include "GameFramework/Actor.h"
 #include "Grid.generated.h"
 
 // macro declaration for a dynamic multicast delegate
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnReset);
 
+class AUnit;
+class UHierarchicalInstancedStaticMeshComponent;
+
+// Packed state of a single board cell, the data the gameplay algorithms read instead of the tile actors
+struct FGridCell
+{
+	// EMPTY or OCCUPIED
+	ETileStatus Status = ETileStatus::EMPTY;
+
+	// Player index, NOT_ASSIGNED (-1) or OBSTACLE_OWNER (-2)
+	int8 Owner = -1;
+
+	// True if the cell is an obstacle
+	uint8 bObstacle : 1;
+
+	// Index into AGrid::BoardUnits of the unit standing here, INDEX_NONE if free
+	int16 UnitSlot = INDEX_NONE;
+
+	FGridCell() : bObstacle(false) {}
+};
+
 UCLASS()
 class TURNBASEDSTRATEGYPAA_API AGrid : public AActor
 {
 	GENERATED_BODY()
 
 public:
-	// array of pointers to Tiles to keep track of them
+	// array of pointers to Tiles, row-major (index = Y * Size + X); with instanced tiles an entry stays null
+	// until GetTileByIndex needs a view of its cell
 	UPROPERTY(Transient)
 	TArray<ATile*> TileArray;
 
-	//given a position returns a tile
+	// units currently standing on the board, addressed by FGridCell::UnitSlot; the slot of a unit leaving
+	// the board is null until a new unit takes it
 	UPROPERTY(Transient)
-	TMap<FVector2D, ATile*> TileMap;
+	TArray<AUnit*> BoardUnits;
 
 	//variable to specify the padding in between tiles
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
@@ -30,6 +57,15 @@ public:
 
 	static const int32 NOT_ASSIGNED = -1;
 
+	// owner value used to mark obstacles
+	static const int32 OBSTACLE_OWNER = -2;
+
+	// number of neighbours of a cell (up, down, right, left)
+	static const int32 NUM_DIRECTIONS = FGridDirections::Num;
+
+	// players tracked by the per-player ownership bitboards
+	static const int32 MAX_PLAYERS = 2;
+
 	UPROPERTY(BlueprintAssignable)
 	FOnReset OnResetEvent;
 
@@ -48,6 +84,38 @@ public:
 	// tile size
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	float TileSize;
+
+	// draw every tile as an instance of TileMesh: the board state lives in the cells only, and a tile actor
+	// without a mesh is spawned the first time a cell is asked for its tile, so large boards cost a handful
+	// of draw calls and no actor per cell
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Instanced Tiles")
+	bool bInstancedTiles;
+
+	UPROPERTY(EditAnywhere, Category = "Instanced Tiles")
+	UStaticMesh* TileMesh;
+
+	// reads the tile color from PerInstanceCustomData 0-2
+	UPROPERTY(EditAnywhere, Category = "Instanced Tiles")
+	UMaterialInterface* TileMaterial;
+
+	// instance colors of each ETileVisual
+	UPROPERTY(EditAnywhere, Category = "Instanced Tiles")
+	FLinearColor GroundColor;
+
+	UPROPERTY(EditAnywhere, Category = "Instanced Tiles")
+	FLinearColor ObstacleColor;
+
+	UPROPERTY(EditAnywhere, Category = "Instanced Tiles")
+	FLinearColor MovementColor;
+
+	UPROPERTY(EditAnywhere, Category = "Instanced Tiles")
+	FLinearColor AttackColor;
+
+	UPROPERTY(EditAnywhere, Category = "Instanced Tiles")
+	FLinearColor SelectionColor;
+
+	// number of custom data floats of a tile instance (RGB)
+	static const int32 NUM_TILE_CUSTOM_DATA = 3;
 	
 public:	
 	// Sets default values for this actor's properties
@@ -70,7 +138,114 @@ public:
 	// return (x,y) position given a relative position
 	FVector2D GetXYPositionByRelativeLocation(const FVector& Location) const;
 
-	void ValidateAllObstacles();
+	// index of the cell at a location relative to the grid, INDEX_NONE if outside the board
+	int32 GetCellIndexByRelativeLocation(const FVector& Location) const;
+
+	// index of the cell where a world-space ray meets the board plane, INDEX_NONE if it misses the board;
+	// constant time, no trace and no tile search
+	int32 GetCellIndexByRay(const FVector& RayOrigin, const FVector& RayDirection) const;
+
+	// row-major index of the (x,y) cell
+	FORCEINLINE int32 GetCellIndex(const int32 InX, const int32 InY) const { return InY * Size + InX; }
+
+	// (x,y) coordinates of a cell index
+	FORCEINLINE FIntPoint GetCellCoords(const int32 Index) const { return FIntPoint(Index % Size, Index / Size); }
+
+	// true if (x,y) is inside the board
+	FORCEINLINE bool IsValidCell(const int32 InX, const int32 InY) const { return InX >= 0 && InX < Size && InY >= 0 && InY < Size; }
+
+	// Manhattan distance between two cells, the range of an attack
+	FORCEINLINE int32 GetCellDistance(const int32 FromIndex, const int32 ToIndex) const
+	{
+		return FMath::Abs(FromIndex % Size - ToIndex % Size) + FMath::Abs(FromIndex / Size - ToIndex / Size);
+	}
+
+	// number of cells of the board
+	FORCEINLINE int32 GetNumCells() const { return Cells.Num(); }
+
+	// index of the neighbour of a cell in the given direction (0..NUM_DIRECTIONS-1), INDEX_NONE if off the board
+	int32 GetNeighbourIndex(const int32 Index, const int32 Direction) const;
+
+	// packed state of a cell
+	FORCEINLINE const FGridCell& GetCell(const int32 Index) const { return Cells[Index]; }
+
+	// tile actor at (x,y), nullptr if outside the board; spawned on demand with instanced tiles
+	ATile* GetTile(const int32 InX, const int32 InY);
+
+	// tile actor at a cell index, spawned on demand with instanced tiles
+	ATile* GetTileByIndex(const int32 Index);
+
+	// tile actor at a cell index if it exists, never spawns one
+	FORCEINLINE ATile* FindTileByIndex(const int32 Index) const { return TileArray.IsValidIndex(Index) ? TileArray[Index] : nullptr; }
+
+	// unit standing on a cell, nullptr if none
+	AUnit* GetCellUnit(const int32 Index) const;
+
+	// true if the cell is free ground a unit can walk on
+	FORCEINLINE bool IsCellWalkable(const int32 Index) const
+	{
+		const FGridCell& Cell = Cells[Index];
+		return Cell.Status == ETileStatus::EMPTY && !Cell.bObstacle && Cell.UnitSlot == INDEX_NONE;
+	}
+
+	// called by the tiles to keep the board state in sync with them
+	void UpdateCellStatus(const int32 Index, const int32 TileOwner, const ETileStatus TileStatus);
+	void UpdateCellUnit(const int32 Index, AUnit* Unit);
+
+	// true if the tiles of the current board are drawn as instances
+	FORCEINLINE bool UsesInstancedTiles() const { return bTilesAreInstances; }
+
+	// recolors the instance of a cell, the render state is sent once at the end of the frame
+	void SetCellVisual(const int32 Index, const ETileVisual Visual);
+
+	FORCEINLINE ETileVisual GetCellVisual(const int32 Index) const { return CellVisuals[Index]; }
+
+	// highlight layers (MOVEMENT, ATTACK, SELECTION, drawn in this order): a layer is replaced as a whole and
+	// only the cells entering or leaving it are redrawn; obstacle cells are never highlighted
+	void SetHighlightedCells(const ETileVisual Highlight, const FGridBitboard& NewCells);
+	void SetHighlightedTiles(const ETileVisual Highlight, const TArray<ATile*>& Tiles);
+	void ClearHighlightedCells(const ETileVisual Highlight);
+
+	// adds or removes a single cell of a layer
+	void SetCellHighlight(const int32 Index, const ETileVisual Highlight, const bool bHighlighted);
+
+	// removes a cell from every layer
+	void ClearCellHighlights(const int32 Index);
+
+	// blueprint event of the tile class drawing a highlight, looked up once per class
+	UFunction* GetTileHighlightEvent(const ETileVisual Highlight);
+
+	// bitboards mirroring the cell state
+	FORCEINLINE const FGridBitboard& GetObstacleBits() const { return ObstacleBits; }
+	FORCEINLINE const FGridBitboard& GetOccupiedBits() const { return OccupiedBits; }
+	FORCEINLINE const FGridBitboard& GetWalkableBits() const { return WalkableBits; }
+	FORCEINLINE const FGridBitboard& GetHighlightBits() const { return HighlightBits; }
+	const FGridBitboard* GetOwnerBits(const int32 PlayerIndex) const;
+
+	// shared BFS engine for movement, attack and connectivity queries (game thread only)
+	FORCEINLINE FGridBFS& GetBFS() { return BFS; }
+
+	// shared A* engine for path queries (game thread only)
+	FORCEINLINE FGridAStar& GetAStar() { return AStar; }
+
+	// bumped on every change of the cell state, results computed for an older version are stale
+	FORCEINLINE uint32 GetBoardVersion() const { return BoardVersion; }
+
+	// cells within Range steps of SourceIndex for the given query, grown a whole ring at a time over the
+	// bitboards and computed once per board version;
+	// the entry lives as long as the grid but is recycled by later queries, check FGridDistanceField::Matches before reusing it
+	const FGridDistanceField& GetDistanceField(const int32 SourceIndex, const int32 Range, const EGridQuery Query);
+
+	// cells reachable from StartIndex in at most MaxSteps 4-neighbour steps, walking only on
+	// Passable cells (any cell if null); the start cell is included
+	void ComputeReachableBits(const int32 StartIndex, const int32 MaxSteps, const FGridBitboard* Passable, FGridBitboard& OutBits) const;
+
+	// the one way to add or remove an obstacle: updates the cell, its tile and the look of the tile together
+	void SetCellObstacle(const int32 Index, const bool bObstacle);
+
+	// debug builds only, with tbs.ValidateGrid 1: checks the cells changed since the last call against their
+	// tiles and repairs them, so the cost follows the changes and not the board size
+	void ValidateDirtyCells();
 
 	bool ValidateConnectivity();
 
@@ -80,6 +255,27 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	USceneComponent* Scene;
+
+	// one instance per cell, instance index == cell index
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UHierarchicalInstancedStaticMeshComponent* TileInstances;
+
+	// set by GenerateGrid, bInstancedTiles only applies if a TileMesh is set
+	bool bTilesAreInstances = false;
+
+	// look of each instance, to only send the ones that change
+	TArray<ETileVisual> CellVisuals;
+
+	// adds one instance per cell in row-major order
+	void SpawnTileInstances();
+
+	// spawns the tile actor of a cell, with instanced tiles it takes the state the cell already has
+	ATile* SpawnTile(const int32 Index, const TSubclassOf<ATile> SpawnClass);
+
+	const FLinearColor& GetVisualColor(const ETileVisual Visual) const;
+
 	// return a (x,y) position given a hit (click) on a grid tile
 	FVector2D GetPosition(const FHitResult& Hit);
 
@@ -90,6 +286,84 @@ protected:
 	// checking if is a valid field position
 	inline bool IsValidPosition(const FVector2D Position) const;
 
+	// contiguous row-major board state, one entry per tile
+	TArray<FGridCell> Cells;
+
+	// one bit per cell: obstacles, cells holding a unit, free ground, highlighted tiles
+	FGridBitboard ObstacleBits;
+	FGridBitboard OccupiedBits;
+	FGridBitboard WalkableBits;
+	FGridBitboard HighlightBits;
+
+	// one bit per cell owned by each player
+	FGridBitboard OwnerBits[MAX_PLAYERS];
+
+	// scratch buffers of the flood fills, the cells before the last step and the cells it added
+	mutable FGridBitboard ScratchBits;
+	FGridBitboard FrontierBits;
+
+	static const int32 NUM_HIGHLIGHT_LAYERS = 3;
+
+	// cells of each highlight layer, HighlightBits is their union
+	FGridBitboard HighlightLayers[NUM_HIGHLIGHT_LAYERS];
+
+	// cells requested by SetHighlightedTiles and cells changed by a layer update
+	FGridBitboard HighlightRequestBits;
+	FGridBitboard HighlightDiffBits;
+
+	// tile events of each highlight layer and of obstacles, resolved for TileEventClass
+	UFunction* HighlightEvents[NUM_HIGHLIGHT_LAYERS] = {};
+	UFunction* ObstacleEvent = nullptr;
+	const UClass* TileEventClass = nullptr;
+
+	// looks the tile events up on TileClass if it changed
+	void ResolveTileEvents();
+
+#if !UE_BUILD_SHIPPING
+	// cells whose state changed since the last ValidateDirtyCells
+	FGridBitboard DirtyCells;
+#endif
+
+	// layer of a highlight visual, INDEX_NONE for GROUND and OBSTACLE
+	static int32 GetHighlightLayer(const ETileVisual Highlight);
+
+	// false for obstacles and cells occupied without a unit
+	bool CanHighlightCell(const int32 Index) const;
+
+	// draws the topmost layer holding the cell, or the plain tile
+	void RedrawCellHighlight(const int32 Index);
+
+	// BFS buffers reused by every query
+	FGridBFS BFS;
+
+	// A* buffers reused by every query
+	FGridAStar AStar;
+
+	// version of the cell state, starts from 1 so a zeroed key never matches
+	uint32 BoardVersion = 1;
+
+	// distance fields of the current board version
+	FGridDistanceCache DistanceCache;
+
+	// recomputes the bitboard bits of a cell from its state
+	void UpdateCellBits(const int32 Index);
+
+	// slot of each unit in BoardUnits and cell it stands on, slots left by the units are reused
+	TMap<AUnit*, int32> UnitSlots;
+	TArray<int32> SlotCells;
+	TArray<int32> FreeUnitSlots;
+
+	// slot of a unit standing on Index, taken from the free slots the first time
+	int32 AcquireUnitSlot(AUnit* Unit, const int32 Index);
+
+	// frees the slot unless its unit already stands on another cell
+	void ReleaseUnitSlot(const int32 Slot, const int32 Index);
+
+	void ClearUnitSlots();
+
+	// destroys the spawned tiles and clears the board state
+	void DestroyTiles();
+
 //public:	
 //	// Called every frame
 //	virtual void Tick(float DeltaTime) override;
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBFS.h"
+
+/**
+ * Reusable A* search over a (size x size) row-major grid with unit step costs.
+ * Nodes are stored per cell and the open list is an indexed binary heap with decrease-key;
+ * all buffers are sized once in Init, so running a query performs no heap allocation.
+ */
+struct TURNBASEDSTRATEGYPAA_API FGridAStar
+{
+public:
+	FGridAStar();
+
+	// size the buffers for a (size x size) grid
+	void Init(const int32 InSize);
+
+	// shortest path from StartIndex to GoalIndex entering only the cells for which CanEnter(Index) is true
+	// (the start cell is never tested, the goal cell is); returns false if the goal can't be reached
+	template <typename PassableFuncType>
+	bool Run(const int32 StartIndex, const int32 GoalIndex, PassableFuncType&& CanEnter)
+	{
+		BeginQuery(GoalIndex);
+		Open(StartIndex, 0, INDEX_NONE);
+
+		while (HeapSize > 0)
+		{
+			const int32 Index = PopBest();
+			if (Index == GoalIndex)
+			{
+				return true;
+			}
+
+			NumExpanded++;
+
+			const int32 X = Index % Size;
+			const int32 Y = Index / Size;
+			const int32 NextScore = Nodes[Index].GScore + 1;
+
+			for (int32 Direction = 0; Direction < FGridDirections::Num; Direction++)
+			{
+				const int32 NextX = X + FGridDirections::X[Direction];
+				const int32 NextY = Y + FGridDirections::Y[Direction];
+
+				if (NextX < 0 || NextX >= Size || NextY < 0 || NextY >= Size)
+				{
+					continue;
+				}
+
+				const int32 NextIndex = NextY * Size + NextX;
+				if (Stamp[NextIndex] == Generation)
+				{
+					// Closed, or already open with a path at least as short
+					const FNode& Next = Nodes[NextIndex];
+					if (Next.HeapIndex == CLOSED || NextScore >= Next.GScore)
+					{
+						continue;
+					}
+
+					Nodes[NextIndex].GScore = NextScore;
+					Nodes[NextIndex].FScore = NextScore + GetHeuristic(NextIndex);
+					Nodes[NextIndex].ParentIndex = Index;
+					SiftUp(Next.HeapIndex);
+				}
+				else if (CanEnter(NextIndex))
+				{
+					Open(NextIndex, NextScore, Index);
+				}
+			}
+		}
+
+		return false;
+	}
+
+	// results of the last successful query
+	// number of steps from the start to the goal
+	FORCEINLINE int32 GetPathLength() const { return Nodes[GoalIndex].GScore; }
+
+	// cells from the first step to the goal (the start is not included)
+	void GetPath(TArray<int32>& OutPath) const;
+
+	// nodes expanded by the last query
+	FORCEINLINE int32 GetNumExpanded() const { return NumExpanded; }
+
+	FORCEINLINE int32 GetSize() const { return Size; }
+
+	// Manhattan distance between two cells, admissible and consistent on a 4-connected grid
+	FORCEINLINE int32 GetDistance(const int32 FromIndex, const int32 ToIndex) const
+	{
+		return FMath::Abs(FromIndex % Size - ToIndex % Size) + FMath::Abs(FromIndex / Size - ToIndex / Size);
+	}
+
+private:
+	// heap position of the nodes already expanded
+	static const int32 CLOSED = -2;
+
+	struct FNode
+	{
+		int32 GScore;		// steps from the start
+		int32 FScore;		// GScore + estimate to the goal
+		int32 ParentIndex;	// previous cell on the best path
+		int32 HeapIndex;	// position in the open list, CLOSED once expanded
+	};
+
+	// invalidates the previous query results
+	void BeginQuery(const int32 InGoalIndex);
+
+	FORCEINLINE int32 GetHeuristic(const int32 Index) const { return GetDistance(Index, GoalIndex); }
+
+	FORCEINLINE void Open(const int32 Index, const int32 InGScore, const int32 InParentIndex)
+	{
+		Stamp[Index] = Generation;
+
+		FNode& Node = Nodes[Index];
+		Node.GScore = InGScore;
+		Node.FScore = InGScore + GetHeuristic(Index);
+		Node.ParentIndex = InParentIndex;
+		Node.HeapIndex = HeapSize;
+
+		Heap[HeapSize++] = Index;
+		SiftUp(Node.HeapIndex);
+	}
+
+	// on equal F the deeper node goes first: it's closer to the goal, so fewer ties get expanded
+	FORCEINLINE bool IsBetter(const int32 A, const int32 B) const
+	{
+		const FNode& NodeA = Nodes[A];
+		const FNode& NodeB = Nodes[B];
+		return NodeA.FScore < NodeB.FScore || (NodeA.FScore == NodeB.FScore && NodeA.GScore > NodeB.GScore);
+	}
+
+	// binary heap over Heap[0, HeapSize), every node knows its own position
+	int32 PopBest();
+	void SiftUp(int32 Position);
+	void SiftDown(int32 Position);
+
+	int32 Size;
+	int32 GoalIndex;
+	int32 NumExpanded;
+
+	// stamp value marking the nodes touched by the current query
+	uint32 Generation;
+
+	int32 HeapSize;
+
+	TArray<FNode> Nodes;
+	TArray<uint32> Stamp;
+	TArray<int32> Heap;
+};
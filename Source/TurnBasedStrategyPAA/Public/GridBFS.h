@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// (x, y) offsets of the four cardinal directions: up, down, right, left
+struct FGridDirections
+{
+	static constexpr int32 Num = 4;
+	static constexpr int32 X[Num] = { 0, 0, 1, -1 };
+	static constexpr int32 Y[Num] = { 1, -1, 0, 0 };
+};
+
+/**
+ * Reusable breadth-first search over a (size x size) row-major grid.
+ * All buffers are sized once in Init, queries only bump a generation counter,
+ * so running a query performs no heap allocation.
+ */
+struct TURNBASEDSTRATEGYPAA_API FGridBFS
+{
+public:
+	FGridBFS();
+
+	// size the buffers for a (size x size) grid
+	void Init(const int32 InSize);
+
+	// explores from StartIndex up to MaxDistance steps (unbounded if negative), entering only
+	// the cells for which CanEnter(Index) is true; the start cell is always visited
+	// returns the number of visited cells
+	template <typename PassableFuncType>
+	int32 Run(const int32 StartIndex, const int32 MaxDistance, PassableFuncType&& CanEnter)
+	{
+		BeginQuery();
+		Visit(StartIndex, 0, INDEX_NONE);
+
+		while (Head < Tail)
+		{
+			const int32 Index = Queue[Head++];
+			const int32 NextDistance = Distance[Index] + 1;
+
+			// Don't expand past the maximum distance
+			if (MaxDistance >= 0 && NextDistance > MaxDistance)
+			{
+				continue;
+			}
+
+			const int32 X = Index % Size;
+			const int32 Y = Index / Size;
+
+			for (int32 Direction = 0; Direction < FGridDirections::Num; Direction++)
+			{
+				const int32 NextX = X + FGridDirections::X[Direction];
+				const int32 NextY = Y + FGridDirections::Y[Direction];
+
+				if (NextX < 0 || NextX >= Size || NextY < 0 || NextY >= Size)
+				{
+					continue;
+				}
+
+				const int32 NextIndex = NextY * Size + NextX;
+				if (Stamp[NextIndex] == Generation || !CanEnter(NextIndex))
+				{
+					continue;
+				}
+
+				Visit(NextIndex, NextDistance, Index);
+			}
+		}
+
+		return Tail;
+	}
+
+	// results of the last query
+	FORCEINLINE bool IsVisited(const int32 Index) const { return Stamp[Index] == Generation; }
+	FORCEINLINE int32 GetDistance(const int32 Index) const { return IsVisited(Index) ? Distance[Index] : INDEX_NONE; }
+	FORCEINLINE int32 GetParent(const int32 Index) const { return IsVisited(Index) ? Parent[Index] : INDEX_NONE; }
+
+	// visited cells of the last query, in visiting (non-decreasing distance) order
+	FORCEINLINE TArrayView<const int32> GetVisitedCells() const { return MakeArrayView(Queue.GetData(), Tail); }
+
+	FORCEINLINE int32 GetSize() const { return Size; }
+
+private:
+	// invalidates the previous query results
+	void BeginQuery();
+
+	FORCEINLINE void Visit(const int32 Index, const int32 InDistance, const int32 InParent)
+	{
+		Stamp[Index] = Generation;
+		Distance[Index] = InDistance;
+		Parent[Index] = InParent;
+		Queue[Tail++] = Index;
+	}
+
+	int32 Size;
+
+	// stamp value marking the cells visited by the current query
+	uint32 Generation;
+
+	// FIFO over Queue: every cell is pushed at most once per query, so the buffer
+	// sized to the board never overflows and also keeps the visiting order
+	int32 Head;
+	int32 Tail;
+
+	TArray<int32> Queue;
+	TArray<int32> Distance;
+	TArray<int32> Parent;
+	TArray<uint32> Stamp;
+};
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * One bit per grid cell, rows packed in uint64 words (row y starts at word y * WordsPerRow)
+ */
+struct TURNBASEDSTRATEGYPAA_API FGridBitboard
+{
+public:
+	FGridBitboard();
+
+	// resize for a (size x size) grid and clear every bit
+	void Init(const int32 InSize);
+
+	// clear every bit
+	void Reset();
+
+	// set every bit of the board
+	void SetAll();
+
+	// get/set the bit of a row-major cell index
+	bool Get(const int32 Index) const;
+	void Set(const int32 Index, const bool bValue);
+
+	// number of set bits
+	int32 CountBits() const;
+
+	// true if no bit is set
+	bool IsEmpty() const;
+
+	// bitwise operations between boards of the same size
+	FGridBitboard& operator&=(const FGridBitboard& Other);
+	FGridBitboard& operator|=(const FGridBitboard& Other);
+	FGridBitboard& operator^=(const FGridBitboard& Other);
+	void AndNot(const FGridBitboard& Other);
+
+	// one BFS step: adds the 4-neighbours of the set cells, limited to Passable (whole board if null)
+	// returns false if nothing was added; Scratch is left holding the cells before the step
+	bool Dilate(const FGridBitboard* Passable, FGridBitboard& Scratch);
+
+	// keeps only the cells reachable from StartIndex in at most MaxSteps steps (unbounded if negative)
+	// through Passable cells; the start cell itself is always included
+	void FloodFill(const int32 StartIndex, const int32 MaxSteps, const FGridBitboard* Passable, FGridBitboard& Scratch);
+
+	// calls Func(Index) for every set cell, in row-major order
+	template <typename FuncType>
+	void ForEachSetBit(FuncType&& Func) const
+	{
+		for (int32 Row = 0; Row < Size; Row++)
+		{
+			for (int32 WordInRow = 0; WordInRow < WordsPerRow; WordInRow++)
+			{
+				uint64 Word = Words[Row * WordsPerRow + WordInRow];
+				while (Word)
+				{
+					const int32 Bit = static_cast<int32>(FMath::CountTrailingZeros64(Word));
+					Func(Row * Size + WordInRow * 64 + Bit);
+					Word &= Word - 1;
+				}
+			}
+		}
+	}
+
+	FORCEINLINE int32 GetSize() const { return Size; }
+
+private:
+	// side of the grid
+	int32 Size;
+
+	// words used by a single row
+	int32 WordsPerRow;
+
+	// valid bits of the last word of each row
+	uint64 TailMask;
+
+	TArray<uint64> Words;
+};
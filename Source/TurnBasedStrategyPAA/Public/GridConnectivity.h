@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBFS.h"
+
+// Answer of a connectivity query
+enum class EGridBlockCheck : uint8
+{
+	Safe,
+	Disconnects,
+	Unknown		// can't be told without rebuilding the block structure
+};
+
+/**
+ * Tracks the free cells of a (size x size) grid while obstacles are added one at a time,
+ * and answers whether blocking a cell would split the free space in two.
+ * The free space is assumed to be connected before every query.
+ */
+struct TURNBASEDSTRATEGYPAA_API FGridConnectivity
+{
+public:
+	FGridConnectivity();
+
+	// size the buffers for a (size x size) grid, every cell starts free
+	void Init(const int32 InSize);
+
+	FORCEINLINE bool IsFree(const int32 Index) const { return FreeCells[Index]; }
+	FORCEINLINE int32 GetFreeCount() const { return FreeCount; }
+
+	// cheap check: looks around the cell and at the last block structure, never rebuilds it
+	EGridBlockCheck CheckBlock(const int32 Index);
+
+	// exact check: true if the remaining free cells stay connected once Index is blocked
+	// rebuilds the block structure (linear in the grid) when CheckBlock can't tell
+	bool CanBlock(const int32 Index);
+
+	// marks a free cell as blocked
+	void Block(const int32 Index);
+
+private:
+	// block id of the cells shared by several blocks (the cut cells)
+	static const int32 SHARED_BLOCK = -2;
+
+	// groups of free orthogonal neighbours joined through the 8 cells around Index
+	// returns the number of groups and one representative neighbour per group
+	int32 GetRingGroups(const int32 Index, int32 OutGroupCells[4]) const;
+
+	// search up to Radius steps around Index: 1 if the groups meet again, 0 if they are proven split,
+	// INDEX_NONE if the radius was not enough to decide
+	int32 CheckGroupsLocally(const int32 Index, const int32* GroupCells, const int32 NumGroups, const int32 Radius);
+
+	// splits the free cells in biconnected blocks (Tarjan, with an explicit stack)
+	void RebuildBlocks();
+
+	bool IsFreeAt(const int32 X, const int32 Y) const;
+
+	int32 Size;
+	int32 FreeCount;
+
+	// one flag per cell, the searches below read it for every neighbour
+	TArray<bool> FreeCells;
+
+	// biconnected block of every free cell as of the last rebuild, SHARED_BLOCK for cut cells
+	// blocking a cell can only change the block it belongs to, the other blocks stay valid
+	TArray<int32> BlockIds;
+	TArray<bool> DirtyBlocks;
+	bool bAllBlocksDirty;
+
+	// buffers of the local search
+	FGridBFS LocalBFS;
+
+	// buffers of the block search
+	TArray<int32> Discovery;
+	TArray<int32> Low;
+	TArray<int32> StackCells;
+	TArray<uint8> StackDirections;
+	TArray<int32> BlockStack;
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBitboard.h"
+
+// Kind of area computed around a cell
+enum class EGridQuery : uint8
+{
+	Movement,	// walking on free ground only
+	Attack		// straight through anything
+};
+
+// Cells reached from a source cell within a range, with their distance
+struct TURNBASEDSTRATEGYPAA_API FGridDistanceField
+{
+	int32 SourceIndex = INDEX_NONE;
+	int32 Range = 0;
+	EGridQuery Query = EGridQuery::Movement;
+
+	// board version the field was computed for
+	uint32 Version = 0;
+
+	// reached cells in non-decreasing distance order (the source first), Distances[i] belongs to Cells[i]
+	TArray<int32> Cells;
+	TArray<int32> Distances;
+
+	// same cells, one bit each, for constant time membership tests
+	FGridBitboard Reached;
+
+	FORCEINLINE bool Contains(const int32 Index) const { return Reached.Get(Index); }
+
+	// true if the field holds this query on this board version
+	FORCEINLINE bool Matches(const int32 InSourceIndex, const int32 InRange, const EGridQuery InQuery, const uint32 InVersion) const
+	{
+		return Version == InVersion && SourceIndex == InSourceIndex && Range == InRange && Query == InQuery;
+	}
+};
+
+/**
+ * Last few distance fields computed on a board, reused while the board doesn't change
+ * Entries are recycled oldest first and keep their buffers
+ */
+struct TURNBASEDSTRATEGYPAA_API FGridDistanceCache
+{
+public:
+	// fields kept at once (a couple of units queried a few times per turn)
+	static const int32 NUM_ENTRIES = 8;
+
+	FGridDistanceCache();
+
+	// the matching field, null if it must be computed
+	const FGridDistanceField* Find(const int32 SourceIndex, const int32 Range, const EGridQuery Query, const uint32 Version) const;
+
+	// entry to fill with a new field, set up with its key
+	FGridDistanceField& Add(const int32 SourceIndex, const int32 Range, const EGridQuery Query, const uint32 Version);
+
+	// forget every field
+	void Reset();
+
+private:
+	// entry replaced by the next Add
+	int32 NextEntry;
+
+	FGridDistanceField Entries[NUM_ENTRIES];
+};
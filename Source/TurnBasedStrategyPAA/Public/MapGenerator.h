@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GridBitboard.h"
+#include "TBSRandom.h"
+#include "Tasks/Task.h"
+
+// Obstacle layout of a map, fully determined by its seed, size and obstacle percentage
+struct TURNBASEDSTRATEGYPAA_API FMapLayout
+{
+	int32 Seed = 0;
+	float ObstaclePercentage = 0.0f;
+	int32 NumObstacles = 0;
+
+	// one bit per cell, set for obstacles
+	FGridBitboard Obstacles;
+
+	FORCEINLINE int32 GetSize() const { return Obstacles.GetSize(); }
+};
+
+/**
+ * Obstacle layout generator, only touches its own data so it can run on any thread
+ * The free cells of a generated map are always connected
+ */
+struct TURNBASEDSTRATEGYPAA_API FMapGenerator
+{
+	// highest share of obstacles on a map
+	static constexpr float MAX_OBSTACLE_RATIO = 0.7f;
+
+	// builds the layout for the given seed, same inputs always give the same map
+	static void Generate(const int32 Seed, const int32 Size, const float ObstaclePercentage, FMapLayout& OutLayout);
+
+	// one layout per seed, generated in parallel
+	static void GenerateBatch(const TArrayView<const int32> Seeds, const int32 Size, const float ObstaclePercentage, TArray<FMapLayout>& OutLayouts);
+};
+
+/**
+ * Maps generated ahead of time on worker threads, handed out in seed order
+ * Map number N of a pool always uses seed BaseSeed + N
+ */
+class TURNBASEDSTRATEGYPAA_API FMapPool : public TSharedFromThis<FMapPool, ESPMode::ThreadSafe>
+{
+public:
+	// drops the ready maps and starts a new sequence of seeds
+	void Configure(const int32 InSize, const float InObstaclePercentage, const int32 InBaseSeed, const int32 InPoolSize);
+
+	// starts generating the missing maps in the background, if not already doing it
+	void Refill();
+
+	// next map of the sequence, generated on the spot if the pool ran dry
+	void Pop(FMapLayout& OutLayout);
+
+	// true if the pool was configured with these settings
+	bool Matches(const int32 InSize, const float InObstaclePercentage) const;
+
+	// waits for the background generation, if any
+	void Flush();
+
+private:
+	// guards the fields below, the generation itself runs unlocked
+	mutable FCriticalSection Lock;
+
+	int32 Size = 0;
+	float ObstaclePercentage = 0.0f;
+	int32 PoolSize = 0;
+
+	// seed of the next map to generate
+	int32 NextSeed = 0;
+
+	// bumped by Configure, results of an older refill are dropped
+	int32 Version = 0;
+
+	TArray<FMapLayout> ReadyMaps;
+	UE::Tasks::FTask RefillTask;
+};
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "MoveHistoryEntryWidget.generated.h"
+
+class UTextBlock;
+
+/**
+ * One visible line of UMoveHistoryWidget, recycled by the list view for whichever line scrolls into view
+ */
+UCLASS(Abstract)
+class TURNBASEDSTRATEGYPAA_API UMoveHistoryEntryWidget : public UUserWidget, public IUserObjectListEntry
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidget), Category = "Game History")
+    UTextBlock* LineText;
+
+protected:
+    // Formats the line of the item, the only place history text is built for the list
+    virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+};
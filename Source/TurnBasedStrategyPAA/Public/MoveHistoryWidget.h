@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "MoveHistoryWidget.generated.h"
+
+class UListView;
+
+/**
+ * List item of a move history line, only the line index: the text is formatted by the entry showing it
+ */
+UCLASS()
+class TURNBASEDSTRATEGYPAA_API UMoveHistoryItem : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(BlueprintReadOnly, Category = "Game History")
+    int32 LineIndex = INDEX_NONE;
+};
+
+/**
+ * Move history view: follows the game instance's action log one line at a time.
+ * The list view only creates entry widgets for the visible lines and recycles them while scrolling,
+ * and only the last MaxLines lines are listed, so neither an update nor the list grows with the match.
+ */
+UCLASS(Abstract)
+class TURNBASEDSTRATEGYPAA_API UMoveHistoryWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    // Its entry widget class has to be a UMoveHistoryEntryWidget
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidget), Category = "Game History")
+    UListView* HistoryList;
+
+    // Scroll to each new line as it comes in
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game History")
+    bool bFollowNewLines = true;
+
+    // Lines listed at once, older ones leave the list (the action log keeps them all); 0 for no limit
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game History")
+    int32 MaxLines = 200;
+
+protected:
+    virtual void NativeConstruct() override;
+    virtual void NativeDestruct() override;
+
+    UFUNCTION()
+    void OnLinesAppended(int32 FirstLine, int32 NumLines);
+
+    UFUNCTION()
+    void OnHistoryCleared();
+
+    // Items created so far, reused after a clear and when the oldest line leaves a full list
+    UPROPERTY(Transient)
+    TArray<UMoveHistoryItem*> ItemPool;
+
+    // Pool items handed to the list since the last clear
+    int32 NumPooledItemsUsed = 0;
+
+    // A free item of the pool, or the oldest listed one once the list is full
+    UMoveHistoryItem* AcquireItem(bool& bOutRecycled);
+};
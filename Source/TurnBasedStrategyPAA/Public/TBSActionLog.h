@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Unit.h"
+
+// What a logged action did
+enum class ETBSLogAction : uint8
+{
+	Place,
+	Move,
+	Attack,
+	Skip
+};
+
+// One logged action, 10 bytes. Cells are Y * GridSize + X, as in AGrid
+struct FTBSLogRecord
+{
+	ETBSLogAction Action = ETBSLogAction::Skip;
+	uint8 Player = 0;
+
+	// A player has one unit per type, so the type identifies the unit
+	EUnitType Unit = EUnitType::NONE;
+
+	// Rolled damage of an attack and counter-damage taken by the attacker (0 if none)
+	uint8 Damage = 0;
+	uint8 CounterDamage = 0;
+
+	// Cell the unit left (moves), cell it reached, was placed on or attacked
+	uint16 FromCell = 0;
+	uint16 ToCell = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FTBSLogRecord& Record);
+};
+
+static_assert(sizeof(FTBSLogRecord) == 10, "Log records are meant to stay 10 bytes");
+
+/**
+ * Binary log of one round: what the map was, who started, and every action with its rolls.
+ * Records are appended as the round is played and only turned into text when a line is shown,
+ * a round of a few hundred actions takes a few KB. FTBSReplay plays a log back.
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSActionLog
+{
+public:
+	FTBSActionLog();
+
+	// Drops the records and the round header
+	void Reset();
+
+	// Round header, set on an empty log: the map is FMapGenerator::Generate(MapSeed, GridSize, ObstaclePercentage)
+	void BeginRound(const int32 InMatchSeed, const int32 InMapSeed, const int32 InGridSize, const float InObstaclePercentage);
+	void SetStartingPlayer(const int32 Player);
+
+	// Marks the start of a gameplay turn, the first one follows the placement phase
+	void BeginTurn();
+
+	void Add(const FTBSLogRecord& Record);
+
+	FORCEINLINE int32 Num() const { return Records.Num(); }
+	FORCEINLINE const FTBSLogRecord& GetRecord(const int32 Index) const { return Records[Index]; }
+
+	// Record index each gameplay turn starts at; a turn with no action starts where the next one does
+	FORCEINLINE const TArray<int32>& GetTurnStarts() const { return TurnStarts; }
+
+	FORCEINLINE int32 GetMatchSeed() const { return MatchSeed; }
+	FORCEINLINE int32 GetMapSeed() const { return MapSeed; }
+	FORCEINLINE int32 GetGridSize() const { return GridSize; }
+	FORCEINLINE float GetObstaclePercentage() const { return ObstaclePercentage; }
+	FORCEINLINE int32 GetStartingPlayer() const { return StartingPlayer; }
+
+	// Cell index of a grid position
+	int32 GetCell(const FVector2D& Position) const;
+
+	// History line of a record, e.g. "HP: S B4 -> D6"
+	FString FormatRecord(const int32 Index) const;
+
+	bool SaveToFile(const FString& FileName);
+	bool LoadFromFile(const FString& FileName);
+
+	friend FArchive& operator<<(FArchive& Ar, FTBSActionLog& Log);
+
+private:
+	// Grid notation of a cell: row letter (Y), column number (X + 1)
+	FString FormatCell(const int32 Cell) const;
+
+	int32 MatchSeed;
+	int32 MapSeed;
+	int32 GridSize;
+	float ObstaclePercentage;
+	int32 StartingPlayer;
+
+	TArray<FTBSLogRecord> Records;
+	TArray<int32> TurnStarts;
+};
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Unit.h"
+
+/**
+ * Exact odds of the combat rules for the stats of ABrawler and ASniper, computed at compile time.
+ * An attack deals uniform damage in [MinDamage, MaxDamage] (AUnit::Attack); a Sniper shooting a Sniper
+ * or an adjacent Brawler takes uniform 1-3 damage back (ASniper::Attack).
+ * Every query is a table lookup, there is no sampling.
+ */
+struct TURNBASEDSTRATEGYPAA_API FTBSCombatTables
+{
+	// Default unit stats, the unit classes are set up from them
+	static constexpr int32 BRAWLER_MOVEMENT_RANGE = 6;
+	static constexpr int32 BRAWLER_ATTACK_RANGE = 1;
+	static constexpr int32 BRAWLER_MIN_DAMAGE = 1;
+	static constexpr int32 BRAWLER_MAX_DAMAGE = 6;
+	static constexpr int32 BRAWLER_MAX_HEALTH = 40;
+
+	static constexpr int32 SNIPER_MOVEMENT_RANGE = 3;
+	static constexpr int32 SNIPER_ATTACK_RANGE = 10;
+	static constexpr int32 SNIPER_MIN_DAMAGE = 4;
+	static constexpr int32 SNIPER_MAX_DAMAGE = 8;
+	static constexpr int32 SNIPER_MAX_HEALTH = 20;
+
+	static constexpr int32 COUNTER_MIN_DAMAGE = 1;
+	static constexpr int32 COUNTER_MAX_DAMAGE = 3;
+
+	// Range of the tables: health values and consecutive hits
+	static constexpr int32 MAX_HEALTH = BRAWLER_MAX_HEALTH;
+	static constexpr int32 MAX_HITS = 8;
+	static constexpr int32 MAX_TOTAL_DAMAGE = MAX_HITS * SNIPER_MAX_DAMAGE;
+
+	// True if an attacker with these stats is the one tabulated for its type (units edited in the editor may not be)
+	static bool IsTabulated(const EUnitType AttackerType, const int32 MinDamage, const int32 MaxDamage);
+
+	// Probability that NumHits attacks deal exactly Damage in total
+	static float GetDamageProbability(const EUnitType AttackerType, const int32 NumHits, const int32 Damage);
+
+	// Probability that NumHits attacks kill a unit with Health left
+	static float GetKillProbability(const EUnitType AttackerType, const int32 Health, const int32 NumHits = 1);
+
+	// Probability that a unit with Health left has ResultHealth left after NumHits attacks
+	static float GetHealthAfterProbability(const EUnitType AttackerType, const int32 Health, const int32 NumHits, const int32 ResultHealth);
+
+	// Mean health an attack takes off a unit with Health left, overkill not counted
+	static float GetExpectedDamage(const EUnitType AttackerType, const int32 Health);
+
+	// Same rule as ASniper::Attack
+	FORCEINLINE static bool HasCounterDamage(const EUnitType AttackerType, const EUnitType TargetType, const int32 Distance)
+	{
+		return AttackerType == EUnitType::SNIPER && (TargetType == EUnitType::SNIPER || (TargetType == EUnitType::BRAWLER && Distance <= 1));
+	}
+
+	// Probability that the counter-damage kills an attacker with Health left
+	static float GetCounterKillProbability(const int32 Health);
+
+	// Mean health the counter-damage takes off an attacker with Health left
+	static float GetExpectedCounterDamage(const int32 Health);
+};
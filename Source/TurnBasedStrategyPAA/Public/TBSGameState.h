@@ -0,0 +1,214 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Unit.h"
+#include "TBSCombatTables.h"
+#include "GridBFS.h"
+
+// State of a single unit in the game model
+struct FTBSUnitState
+{
+	EUnitType Type = EUnitType::NONE;
+
+	// Player index
+	int8 Owner = INDEX_NONE;
+
+	// Actions already used this turn
+	bool bMoved = false;
+	bool bAttacked = false;
+
+	// Cell the unit stands on, kept after death so an unmake can put it back
+	int32 Cell = INDEX_NONE;
+
+	int32 Health = 0;
+	int32 MaxHealth = 0;
+
+	// Stats copied from the unit actor
+	int32 MovementRange = 0;
+	int32 AttackRange = 0;
+	int32 MinDamage = 0;
+	int32 MaxDamage = 0;
+
+	FORCEINLINE bool IsAlive() const { return Health > 0; }
+
+	// A unit with the stats ABrawler and ASniper are spawned with
+	static FTBSUnitState MakeDefault(const EUnitType InType, const int32 InOwner, const int32 InCell);
+};
+
+enum class ETBSActionType : uint8
+{
+	Move,
+	Attack,
+	EndTurn
+};
+
+// A single player action: a unit moves, a unit attacks another one, or the turn ends
+struct FTBSAction
+{
+	ETBSActionType Type = ETBSActionType::EndTurn;
+
+	// Acting unit and attacked unit, indices into FTBSGameState::Units
+	int8 Unit = INDEX_NONE;
+	int8 Target = INDEX_NONE;
+
+	// Destination of a move
+	int32 Cell = INDEX_NONE;
+
+	static FTBSAction MakeMove(const int32 InUnit, const int32 InCell);
+	static FTBSAction MakeAttack(const int32 InUnit, const int32 InTarget);
+	static FTBSAction MakeEndTurn();
+
+	FORCEINLINE bool operator==(const FTBSAction& Other) const
+	{
+		return Type == Other.Type && Unit == Other.Unit && Target == Other.Target && Cell == Other.Cell;
+	}
+};
+
+// What an applied action changed, enough to take it back
+struct FTBSUndo
+{
+	FTBSAction Action;
+
+	// Cell the unit moved from
+	int32 FromCell = INDEX_NONE;
+
+	// Health before the attack
+	int32 UnitHealth = 0;
+	int32 TargetHealth = 0;
+
+	// Turn flags before the action, two bits per unit (moved, attacked)
+	uint32 Flags = 0;
+
+	int32 SideToMove = 0;
+
+	// Position key before the action
+	uint64 Key = 0;
+};
+
+/**
+ * Compact copy of a match: board, units and turn, with the rules of AUnit, ASniper and ATBS_GameMode.
+ * No actor is involved, so it can be copied and searched on any thread.
+ * Actions are applied with MakeAction and taken back with UnmakeAction, damage rolls are chosen by the caller.
+ * A Zobrist key of the position (board, units, health, turn flags, side to move) is kept up to date by every change.
+ */
+struct TURNBASEDSTRATEGYPAA_API FTBSGameState
+{
+public:
+	// Units tracked by the model, two bits each in FTBSUndo::Flags
+	static constexpr int32 MAX_UNITS = 16;
+
+	static constexpr int32 NUM_PLAYERS = 2;
+
+	// Cell contents besides a unit index
+	static constexpr int8 EMPTY_CELL = -1;
+	static constexpr int8 OBSTACLE_CELL = -2;
+
+	// Damage a Sniper takes when it attacks a Sniper or an adjacent Brawler
+	static constexpr int32 COUNTER_MIN_DAMAGE = FTBSCombatTables::COUNTER_MIN_DAMAGE;
+	static constexpr int32 COUNTER_MAX_DAMAGE = FTBSCombatTables::COUNTER_MAX_DAMAGE;
+
+	// Returned by GetWinner when nobody is left standing
+	static constexpr int32 DRAW = NUM_PLAYERS;
+
+	FTBSGameState();
+
+	// Empty (size x size) board, no units
+	void Init(const int32 InSize);
+
+	void SetObstacle(const int32 Index);
+
+	// Places a unit on a free cell, returns its index or INDEX_NONE if the model is full
+	int32 AddUnit(const FTBSUnitState& Unit);
+
+	FORCEINLINE int32 GetSize() const { return Size; }
+	FORCEINLINE int32 GetNumCells() const { return Cells.Num(); }
+	FORCEINLINE int32 GetSideToMove() const { return SideToMove; }
+	void SetSideToMove(const int32 Side);
+
+	// Zobrist key of the position, equal positions reached in any order share it
+	FORCEINLINE uint64 GetKey() const { return Key; }
+
+	// Key computed from scratch, to check the incremental one
+	uint64 ComputeKey() const;
+
+	FORCEINLINE int32 GetNumUnits() const { return Units.Num(); }
+	FORCEINLINE const FTBSUnitState& GetUnit(const int32 UnitIndex) const { return Units[UnitIndex]; }
+	FORCEINLINE int32 GetNumAlive(const int32 Player) const { return AliveCount[Player]; }
+
+	// Unit index, EMPTY_CELL or OBSTACLE_CELL
+	FORCEINLINE int8 GetCellContent(const int32 Index) const { return Cells[Index]; }
+	FORCEINLINE bool IsWalkable(const int32 Index) const { return Cells[Index] == EMPTY_CELL; }
+
+	FORCEINLINE int32 GetCellDistance(const int32 FromIndex, const int32 ToIndex) const
+	{
+		return FMath::Abs(FromIndex % Size - ToIndex % Size) + FMath::Abs(FromIndex / Size - ToIndex / Size);
+	}
+
+	// The match ends as soon as a player has no unit left
+	FORCEINLINE bool IsGameOver() const { return AliveCount[0] == 0 || AliveCount[1] == 0; }
+
+	// Player with units left, DRAW if none, INDEX_NONE while the match is going on
+	int32 GetWinner() const;
+
+	// True if Attacker can hit Target from where they stand (Manhattan range, through obstacles)
+	bool CanAttack(const int32 AttackerIndex, const int32 TargetIndex) const;
+
+	// True if the attack hurts the attacker too: a Sniper shooting a Sniper, or a Brawler next to it
+	bool HasCounterDamage(const int32 AttackerIndex, const int32 TargetIndex) const;
+
+	// Mean rolls, rounded down
+	FORCEINLINE static int32 GetExpectedDamage(const FTBSUnitState& Unit) { return (Unit.MinDamage + Unit.MaxDamage) / 2; }
+	FORCEINLINE static int32 GetExpectedCounterDamage() { return (COUNTER_MIN_DAMAGE + COUNTER_MAX_DAMAGE) / 2; }
+
+	// Cells a unit can walk to this turn (the current cell excluded), the BFS keeps the distances
+	void FindMoveCells(const int32 UnitIndex, FGridBFS& BFS, TArray<int32>& OutCells) const;
+
+	// Every legal action of the side to move, EndTurn last
+	void GenerateActions(FGridBFS& BFS, TArray<FTBSAction>& OutActions) const;
+
+	// Applies a legal action; Damage and CounterDamage are only read by attacks
+	// (CounterDamage is ignored when the attack has no counter-damage)
+	void MakeAction(const FTBSAction& Action, const int32 Damage, const int32 CounterDamage, FTBSUndo& OutUndo);
+
+	// Same with the mean rolls
+	void MakeExpectedAction(const FTBSAction& Action, FTBSUndo& OutUndo);
+
+	// Takes back the last applied action
+	void UnmakeAction(const FTBSUndo& Undo);
+
+private:
+	FORCEINLINE uint32 PackFlags() const
+	{
+		uint32 Flags = 0;
+		for (int32 UnitIndex = 0; UnitIndex < Units.Num(); UnitIndex++)
+		{
+			Flags |= (Units[UnitIndex].bMoved ? 1u : 0u) << (UnitIndex * 2);
+			Flags |= (Units[UnitIndex].bAttacked ? 2u : 0u) << (UnitIndex * 2);
+		}
+		return Flags;
+	}
+
+	// Key of everything a unit contributes to the position
+	uint64 GetUnitKey(const int32 UnitIndex) const;
+
+	// Removes Amount health, takes a dying unit off the board
+	void ApplyDamage(const int32 UnitIndex, const int32 Amount);
+
+	// Puts back the health of a unit, and the unit on the board if it was dead
+	void RestoreHealth(const int32 UnitIndex, const int32 Health);
+
+	int32 Size;
+	int32 SideToMove;
+
+	// One entry per cell: unit index, EMPTY_CELL or OBSTACLE_CELL
+	TArray<int8> Cells;
+
+	TArray<FTBSUnitState, TInlineAllocator<MAX_UNITS>> Units;
+
+	// Units alive per player
+	int32 AliveCount[NUM_PLAYERS];
+
+	uint64 Key;
+};
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TBSGameState.h"
+#include "TBSSearch.h"
+#include "TBSMonteCarlo.h"
+#include "MapGenerator.h"
+#include "TBSRandom.h"
+#include "TBSActionLog.h"
+
+// Who plays a side of a simulated match
+enum class ETBSSimAgent : uint8
+{
+	// Random moves and attacks, like ATBS_NaiveAI
+	Random,
+	AlphaBeta,
+	MonteCarlo
+};
+
+struct FTBSSimPlayer
+{
+	ETBSSimAgent Agent = ETBSSimAgent::AlphaBeta;
+
+	// Engine settings of the search agents
+	FTBSSearchSettings Search;
+	FTBSMonteCarloSettings MonteCarlo;
+};
+
+// Rules and players of a simulated match, the defaults are those of ATBS_GameMode
+struct FTBSMatchSettings
+{
+	int32 GridSize = 25;
+	float ObstaclePercentage = 10.0f;
+
+	// Seed of the map and of the match random streams: the same seed replays the same match as long as
+	// the search agents stop on node or iteration budgets (or a fixed depth), a time budget makes
+	// their plans depend on the machine and its load
+	int32 Seed = 0;
+
+	// Turns (of either player) after which the match is called a draw
+	int32 MaxTurns = 200;
+
+	// Searches a search agent may start in one turn, as in ATBS_SmartAI
+	int32 MaxSearchesPerTurn = 8;
+
+	FTBSSimPlayer Players[FTBSGameState::NUM_PLAYERS];
+};
+
+struct FTBSMatchResult
+{
+	// Player index, or FTBSGameState::DRAW
+	int32 Winner = INDEX_NONE;
+
+	// True if the draw comes from MaxTurns
+	bool bTurnLimit = false;
+
+	// Winner of the coin toss, places and plays first
+	int32 StartingPlayer = 0;
+
+	int32 NumTurns = 0;
+	int32 NumActions = 0;
+
+	// Time spent deciding, per player
+	double ThinkSeconds[FTBSGameState::NUM_PLAYERS] = {};
+
+	double Seconds = 0.0;
+};
+
+/**
+ * Plays whole matches on FTBSGameState without actors, widgets or a world: map generation, coin toss,
+ * placement and turns follow ATBS_GameMode, moves and attacks follow AUnit and ASniper.
+ * A simulator plays one match at a time and keeps its buffers; use one per thread.
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSMatchSimulator
+{
+public:
+	// Plays a match, and logs it in OutLog if given (FTBSReplay plays it back)
+	void Play(const FTBSMatchSettings& Settings, FTBSMatchResult& OutResult, FTBSActionLog* OutLog = nullptr);
+
+	// Plays NumMatches matches across the cores, match N uses seed Settings.Seed + N;
+	// Monte Carlo agents search a single tree, the matches already fill the cores
+	static void PlayBatch(const FTBSMatchSettings& Settings, const int32 NumMatches, TArray<FTBSMatchResult>& OutResults);
+
+private:
+	// Coin toss winner first, then alternating, each player places the types it has left in random order
+	void PlaceUnits(const int32 StartingPlayer);
+
+	// Plays the turn of the side to move, up to and including its EndTurn
+	void PlayTurn(const FTBSSimPlayer& Player, FTBSMatchResult& OutResult);
+
+	void PlayRandomTurn(FTBSMatchResult& OutResult);
+	void PlaySearchTurn(const FTBSSimPlayer& Player, FTBSMatchResult& OutResult);
+
+	// Applies a legal action with rolled damage
+	void ApplyAction(const FTBSAction& Action, FTBSMatchResult& OutResult);
+
+	// Attacks a random target in range, as ATBS_NaiveAI does
+	void RandomAttack(const int32 UnitIndex, FTBSMatchResult& OutResult);
+
+	// True if the action can be played in the current state
+	bool IsLegal(const FTBSAction& Action);
+
+	FTBSMatchSettings Settings;
+	FTBSMatchRandom Random;
+
+	// Log of the match being played, if any
+	FTBSActionLog* Log = nullptr;
+
+	FMapLayout Layout;
+	FTBSGameState State;
+	FGridBFS BFS;
+
+	FTBSSearch Search;
+	FTBSMonteCarlo MonteCarlo;
+
+	// Scratch buffers
+	TArray<FTBSAction> LegalActions;
+	TArray<int32> Cells;
+	TArray<int32> Order;
+};
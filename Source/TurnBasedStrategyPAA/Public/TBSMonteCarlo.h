@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TBSSearch.h"
+#include "GridBFS.h"
+#include "TBSRandom.h"
+
+// Limits and knobs of a Monte Carlo search
+struct FTBSMonteCarloSettings
+{
+	// Wall clock budget in seconds
+	float TimeBudget = 1.0f;
+
+	// Iterations per tree replacing the time budget if positive: the same seed then always gives the same plan
+	int32 MaxIterations = 0;
+
+	// Independent trees searched in parallel and merged at the end, 0 for one per core
+	int32 NumTrees = 0;
+
+	// UCT exploration constant, higher tries more alternatives
+	float Exploration = 0.7f;
+
+	// Turns played by a rollout before the position is scored
+	int32 RolloutTurns = 4;
+
+	// Destinations kept per unit when a node is expanded
+	int32 MaxMovesPerUnit = 6;
+
+	// Seed of the damage rolls and of the rollout choices
+	int32 Seed = 0;
+};
+
+/**
+ * One open-loop UCT tree over FTBSGameState.
+ * Damage is rolled for real on every iteration, so statistics average over the rolls.
+ * An action can end in states with different survivors, each one gets its own child node
+ * (the survivors decide which actions are legal, health alone doesn't).
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSMonteCarloTree
+{
+public:
+	// An action out of a node, with the statistics of the player who takes it
+	struct FEdge
+	{
+		FTBSAction Action;
+		int32 Side = 0;
+		int32 Visits = 0;
+		float Value = 0.0f;
+
+		// First node reached through this action, the others follow through FNode::NextOutcome
+		int32 FirstOutcome = INDEX_NONE;
+	};
+
+	// A decision point
+	struct FNode
+	{
+		// Edges [FirstEdge, FirstEdge + NumEdges), INDEX_NONE until expanded
+		int32 FirstEdge = INDEX_NONE;
+		int32 NumEdges = 0;
+
+		// One bit per living unit
+		uint32 AliveMask = 0;
+
+		// Next node reached through the same action with other survivors
+		int32 NextOutcome = INDEX_NONE;
+
+		int32 Visits = 0;
+	};
+
+	FTBSMonteCarloTree();
+
+	// Clears the tree for a new search from Root
+	void Reset(const FTBSGameState& Root, const FTBSMonteCarloSettings& InSettings, const int32 Seed);
+
+	// Selection, expansion, rollout and backup from Root
+	void RunIteration(const FTBSGameState& Root);
+
+	FORCEINLINE int32 GetNumIterations() const { return NumIterations; }
+	FORCEINLINE const FNode& GetNode(const int32 NodeIndex) const { return Nodes[NodeIndex]; }
+	FORCEINLINE const FEdge& GetEdge(const int32 EdgeIndex) const { return Edges[EdgeIndex]; }
+
+	// Node reached through an edge with the given survivors, INDEX_NONE if never seen
+	int32 FindOutcome(const int32 EdgeIndex, const uint32 AliveMask) const;
+
+	// Most visited node reached through an edge, INDEX_NONE if none
+	int32 FindLikeliestOutcome(const int32 EdgeIndex) const;
+
+	static uint32 GetAliveMask(const FTBSGameState& InState);
+
+private:
+	// Adds the edges of a node for the current state
+	void Expand(const int32 NodeIndex);
+
+	// Plays the current state forward with a fast policy, returns the value for player 0
+	float Rollout();
+
+	// One turn of the rollout policy for the side to move
+	void PlayRolloutTurn();
+
+	// Attacks the target in range most likely to die, if any
+	void RolloutAttack(const int32 UnitIndex);
+
+	// Applies an action rolling the damage
+	void MakeRolledAction(const FTBSAction& Action);
+
+	// Value for player 0 of the current state
+	float ScoreState() const;
+
+	FTBSMonteCarloSettings Settings;
+	FTBSRandom Random;
+
+	TArray<FNode> Nodes;
+	TArray<FEdge> Edges;
+
+	int32 NumIterations;
+
+	// Current state of the iteration
+	FTBSGameState State;
+	FGridBFS BFS;
+
+	// Edges walked by the current iteration and the nodes they left from
+	TArray<int32> PathEdges;
+	TArray<int32> PathNodes;
+
+	// Scratch buffers
+	TArray<FTBSAction> NewActions;
+	TArray<int32> MoveCells;
+	TArray<int32> MoveScores;
+	TArray<int32> MoveOrder;
+};
+
+/**
+ * Root-parallel Monte Carlo tree search: every core grows its own tree from the same root
+ * for the whole time budget, the root statistics are merged to pick the plan
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSMonteCarlo
+{
+public:
+	// Searches the turn of the side to move of Root; NumNodes counts the iterations of all the trees
+	void Search(const FTBSGameState& Root, const FTBSMonteCarloSettings& Settings, FTBSSearchResult& OutResult);
+
+private:
+	// Kept between searches to reuse their buffers
+	TArray<FTBSMonteCarloTree> Trees;
+};
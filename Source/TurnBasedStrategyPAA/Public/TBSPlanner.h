@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TBSSearch.h"
+#include "TBSMonteCarlo.h"
+#include "Tasks/Task.h"
+
+/**
+ * Runs turn searches on a worker thread, the game thread only hands over a copy of the match
+ * and polls for the plan, so thinking never blocks rendering or input
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSPlanner : public TSharedFromThis<FTBSPlanner, ESPMode::ThreadSafe>
+{
+public:
+	// starts searching a copy of State in the background, the result of a pending search is dropped
+	void Start(const FTBSGameState& State, const FTBSSearchSettings& Settings);
+
+	// same with the Monte Carlo engine
+	void Start(const FTBSGameState& State, const FTBSMonteCarloSettings& Settings);
+
+	// true once the search of the last Start is done
+	bool IsReady() const;
+
+	// moves out the result of the last Start, false if it isn't ready
+	bool TakeResult(FTBSSearchResult& OutResult);
+
+	// drops the result of the pending search, if any
+	void Cancel();
+
+	// waits for the running search, if any
+	void Flush();
+
+private:
+	// launches Think(Planner, OutResult) after the running search and keeps its result if still wanted
+	template <typename ThinkType>
+	void StartTask(ThinkType&& Think);
+
+	// guards the fields below, the search itself runs unlocked
+	mutable FCriticalSection Lock;
+
+	// bumped by Start and Cancel, results of an older search are dropped
+	int32 Version = 0;
+
+	bool bHasResult = false;
+	FTBSSearchResult Result;
+
+	// searches are chained one after the other, so only one task at a time uses the engine
+	UE::Tasks::FTask SearchTask;
+	FTBSSearch Search;
+	FTBSMonteCarlo MonteCarlo;
+};
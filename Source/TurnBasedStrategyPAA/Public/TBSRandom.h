@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Small, fast seedable generator (PCG32: 64-bit LCG state, permuted 32-bit output).
+ * Unlike FMath::Rand it has no global state, so every owner gets its own reproducible sequence
+ * and threads never share one. Same seed and stream, same numbers on every platform.
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSRandom
+{
+public:
+	FTBSRandom() { Initialize(0); }
+	explicit FTBSRandom(const uint64 Seed, const uint64 Stream = 0) { Initialize(Seed, Stream); }
+
+	// Restarts the sequence; generators with different streams are independent even with the same seed
+	void Initialize(const uint64 Seed, const uint64 Stream = 0);
+
+	FORCEINLINE uint32 GetUInt32()
+	{
+		const uint64 OldState = State;
+		State = OldState * 6364136223846793005ull + Increment;
+		const uint32 XorShifted = static_cast<uint32>(((OldState >> 18) ^ OldState) >> 27);
+		const uint32 Rotation = static_cast<uint32>(OldState >> 59);
+		return (XorShifted >> Rotation) | (XorShifted << ((32 - Rotation) & 31));
+	}
+
+	// Uniform in [Min, Max] like FMath::RandRange, Min if the range is empty
+	FORCEINLINE int32 RandRange(const int32 Min, const int32 Max)
+	{
+		if (Max <= Min)
+		{
+			return Min;
+		}
+
+		// Multiply-shift instead of a modulo, the bias is below 2^-32 per value
+		const uint64 Range = static_cast<uint64>(static_cast<int64>(Max) - Min) + 1;
+		return static_cast<int32>(Min + static_cast<int64>((GetUInt32() * Range) >> 32));
+	}
+
+	// Uniform in [0, 1)
+	FORCEINLINE float GetFraction()
+	{
+		return static_cast<float>(GetUInt32() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	FORCEINLINE float FRandRange(const float Min, const float Max)
+	{
+		return Min + (Max - Min) * GetFraction();
+	}
+
+	FORCEINLINE bool RandBool()
+	{
+		return (GetUInt32() >> 31) != 0;
+	}
+
+private:
+	uint64 State;
+
+	// Odd, selects the stream
+	uint64 Increment;
+};
+
+// Consumers of a match's randomness, each one draws from its own stream
+enum class ETBSRandomStream : uint8
+{
+	// Map seeds
+	Map,
+
+	// Damage and counter-damage rolls
+	Combat,
+
+	// Who places and plays first, kept apart so the maps don't depend on the rounds played before
+	CoinToss,
+
+	// Placement and decisions of an AI, one stream per player from here on
+	AI
+};
+
+/**
+ * Random streams of a match, all derived from one seed.
+ * Map generation, combat, the coin toss and each AI have their own stream, so an extra roll in one of them
+ * (a different AI, a longer search, a human turn) never shifts the numbers of the others.
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSMatchRandom
+{
+public:
+	static constexpr int32 MAX_PLAYERS = 2;
+
+	FTBSMatchRandom() { Initialize(0); }
+
+	void Initialize(const int32 InSeed);
+
+	// The seed the streams started from, initializing again with it replays the same numbers
+	FORCEINLINE int32 GetSeed() const { return Seed; }
+
+	FORCEINLINE FTBSRandom& GetMap() { return Streams[static_cast<int32>(ETBSRandomStream::Map)]; }
+	FORCEINLINE FTBSRandom& GetCombat() { return Streams[static_cast<int32>(ETBSRandomStream::Combat)]; }
+	FORCEINLINE FTBSRandom& GetCoinToss() { return Streams[static_cast<int32>(ETBSRandomStream::CoinToss)]; }
+
+	// Stream of the AI playing PlayerIndex
+	FORCEINLINE FTBSRandom& GetAI(const int32 PlayerIndex)
+	{
+		return Streams[static_cast<int32>(ETBSRandomStream::AI) + FMath::Clamp(PlayerIndex, 0, MAX_PLAYERS - 1)];
+	}
+
+private:
+	static constexpr int32 NUM_STREAMS = static_cast<int32>(ETBSRandomStream::AI) + MAX_PLAYERS;
+
+	int32 Seed;
+	FTBSRandom Streams[NUM_STREAMS];
+};
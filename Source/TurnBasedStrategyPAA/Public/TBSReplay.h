@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TBSActionLog.h"
+#include "TBSGameState.h"
+#include "MapGenerator.h"
+
+/**
+ * Plays an FTBSActionLog back on FTBSGameState: rebuilds the map from its seed, places the units
+ * and applies every action with the logged rolls, so nothing depends on the random streams.
+ * Every record is checked against the rules of the model; a log that doesn't replay stops
+ * at the first action the game and the model disagree on.
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSReplay
+{
+public:
+	FTBSReplay();
+
+	// Rebuilds the board of the log, ready to play its first record; false if the header is invalid
+	bool Start(const FTBSActionLog& InLog);
+
+	// Plays the next record; false at the end of the log or if the record can't be played
+	bool Step();
+
+	// Plays the remaining records, true if the whole log replayed
+	bool Run();
+
+	FORCEINLINE bool IsFinished() const { return !Log || Position >= Log->Num(); }
+
+	// Index of the next record
+	FORCEINLINE int32 GetPosition() const { return Position; }
+
+	FORCEINLINE const FTBSGameState& GetState() const { return State; }
+
+	// Why the replay stopped early, empty if it didn't
+	FORCEINLINE const FString& GetError() const { return Error; }
+
+private:
+	static constexpr int32 NUM_UNIT_TYPES = 3;
+
+	// Ends the turns that start before the next record
+	void AdvanceTurns();
+
+	// Plays a placement, a move or an attack
+	bool PlayRecord(const FTBSLogRecord& Record);
+
+	// Stops the replay at the current record
+	bool Fail(const TCHAR* Reason);
+
+	const FTBSActionLog* Log;
+
+	FMapLayout Layout;
+	FTBSGameState State;
+	FGridBFS BFS;
+	TArray<FTBSAction> LegalActions;
+
+	int32 Position;
+	int32 NextTurn;
+
+	// Model unit of each player and unit type, INDEX_NONE until placed
+	int32 UnitIndices[FTBSGameState::NUM_PLAYERS][NUM_UNIT_TYPES];
+
+	FString Error;
+};
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TBSGameState.h"
+#include "GridBFS.h"
+#include "TBSTranspositionTable.h"
+
+// Limits of a search
+struct FTBSSearchSettings
+{
+	// Wall clock budget in seconds, the deepest completed iteration is used
+	float TimeBudget = 0.5f;
+
+	// Node budget replacing the time budget if positive: the same position then always gets the same plan
+	int64 MaxNodes = 0;
+
+	// Depth limit in actions (a turn is a few moves and attacks plus the end of turn)
+	int32 MaxDepth = 12;
+
+	// Destinations kept per unit and node, the most promising ones first
+	int32 MaxMovesPerUnit = 8;
+
+	// Memory of the transposition table, kept from one search to the next
+	int32 TableSizeMB = 16;
+};
+
+// Outcome of a search
+struct FTBSSearchResult
+{
+	// Actions of the side to move for the rest of its turn, ends with EndTurn unless the horizon cut it
+	TArray<FTBSAction> Plan;
+
+	// Score of the plan for the side to move
+	int32 Score = 0;
+
+	// Deepest completed iteration
+	int32 Depth = 0;
+
+	int64 NumNodes = 0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Alpha-beta search over FTBSGameState with iterative deepening under a time budget.
+ * Every ply is a single action; the score flips sign only when the turn passes to the other player.
+ * Damage rolls are replaced by their mean so the tree stays deterministic.
+ * Positions reached again through another order of the same actions come from the transposition table.
+ * Buffers are sized on the first search of a board, later searches don't allocate.
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSSearch
+{
+public:
+	static constexpr int32 MAX_PLY = 32;
+
+	// Score of a won position, minus the plies needed to get there
+	static constexpr int32 WIN_SCORE = 1000000;
+
+	FTBSSearch();
+
+	// Searches the best turn for the side to move of Root
+	void Search(const FTBSGameState& Root, const FTBSSearchSettings& Settings, FTBSSearchResult& OutResult);
+
+	// Forgets the positions of earlier searches, so a new match doesn't depend on the previous ones
+	FORCEINLINE void ClearTable() { Table.Clear(); }
+
+	// Static score of a position for Side, positive if Side is ahead
+	static int32 Evaluate(const FTBSGameState& State, const int32 Side);
+
+	// Cheap guess of how good standing on Cell is for a unit, used to order and prune moves
+	static int32 ScoreMoveCell(const FTBSGameState& State, const int32 UnitIndex, const int32 Cell);
+
+private:
+	int32 AlphaBeta(const int32 Depth, const int32 Ply, int32 Alpha, const int32 Beta);
+
+	// Legal actions of the current node in search order, with the worst destinations left out
+	void GenerateOrderedActions(const int32 Ply);
+
+	// Checks the node budget, or the clock every thousand nodes
+	bool IsOutOfTime();
+
+	// Completes the best line with the table's best actions where cutoffs on transpositions cut it short
+	void ExtendLineFromTable(const int32 Depth);
+
+	FTBSGameState State;
+	FGridBFS BFS;
+
+	FTBSSearchSettings Settings;
+	double Deadline;
+	bool bAborted;
+	int64 NumNodes;
+	int32 CompletedDepth;
+
+	// Per ply buffers
+	TArray<FTBSAction> Actions[MAX_PLY];
+	TArray<int32> ActionScores[MAX_PLY];
+
+	FTBSTranspositionTable Table;
+
+	// Best action the table had for the node of each ply, searched first
+	FTBSAction TableActions[MAX_PLY];
+
+	// Two quiet actions per ply that caused a cutoff
+	FTBSAction Killers[MAX_PLY][2];
+
+	// Principal variation: line starting at each ply
+	FTBSAction PrincipalVariation[MAX_PLY][MAX_PLY];
+	int32 PrincipalLength[MAX_PLY];
+
+	// Best line of the previous iteration, searched first while the node is on it
+	TArray<FTBSAction> PreviousLine;
+	bool FollowLine[MAX_PLY];
+
+	// Scratch buffers of the move generation and of the line extension
+	TArray<FTBSAction> LegalActions;
+	TArray<FTBSUndo> LineUndos;
+	TArray<int32> MoveCells;
+	TArray<int32> MoveScores;
+	TArray<int32> MoveOrder;
+};
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TBSMatchSimulator.h"
+#include "TBSSimulateCommandlet.generated.h"
+
+/**
+ * Plays AI-vs-AI matches headless and prints win rates and timings, to tune and regression test the AIs.
+ * UnrealEditor-Cmd TurnBasedStrategyPAA.uproject -run=TBSSimulate -Matches=1000 -P0=AlphaBeta -P1=Random
+ * Options: -Matches= -Seed= -Size= -Obstacles= -MaxTurns= -P0= -P1= (Random, AlphaBeta, MonteCarlo)
+ * -Nodes= alpha-beta nodes and -Iterations= Monte Carlo iterations per search (the default budgets, matches are
+ * reproducible), -Think= seconds per search instead (not reproducible), -Depth= fixed alpha-beta depth
+ * -Replay=File plays back an action log saved with ATBS_GameMode::SaveReplay and checks it against the rules
+ */
+UCLASS()
+class TURNBASEDSTRATEGYPAA_API UTBSSimulateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTBSSimulateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Plays back a saved action log, 0 if it replays to the end
+	static int32 RunReplay(const FString& FileName);
+
+	// Reads the -P0= or -P1= agent, false if the name is unknown
+	static bool ParseAgent(const FString& Params, const TCHAR* Key, ETBSSimAgent& OutAgent);
+
+	static const TCHAR* GetAgentName(const ETBSSimAgent Agent);
+};
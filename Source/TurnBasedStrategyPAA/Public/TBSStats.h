@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+/**
+ * Instrumentation of the gameplay hot paths: `stat TBS` in game, and the TBS trace channel
+ * (-trace=default,TBS) plus the TBS/ counters in Unreal Insights captures
+ */
+DECLARE_STATS_GROUP(TEXT("TBS"), STATGROUP_TBS, STATCAT_Advanced);
+
+UE_TRACE_CHANNEL_EXTERN(TBSChannel, TURNBASEDSTRATEGYPAA_API);
+
+// Board queries
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Movement Tiles"), STAT_TBS_MovementTiles, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Attack Tiles"), STAT_TBS_AttackTiles, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Validate Connectivity"), STAT_TBS_ValidateConnectivity, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Highlight Update"), STAT_TBS_HighlightUpdate, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+
+// Match flow
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Obstacles"), STAT_TBS_SpawnObstacles, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Place Unit"), STAT_TBS_PlaceUnit, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("End Turn"), STAT_TBS_EndTurn, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+
+// AI
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Unit Action"), STAT_TBS_AIUnitAction, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Plan Capture"), STAT_TBS_AIPlanCapture, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AI Search (worker)"), STAT_TBS_AISearch, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+
+// HUD
+DECLARE_CYCLE_STAT_EXTERN(TEXT("History Formatting"), STAT_TBS_HistoryFormatting, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+
+// Per-frame counters
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("BFS Nodes Expanded"), STAT_TBS_BFSNodes, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Search Nodes"), STAT_TBS_SearchNodes, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tiles Touched"), STAT_TBS_TilesTouched, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tile Lists Built"), STAT_TBS_TileListsBuilt, STATGROUP_TBS, TURNBASEDSTRATEGYPAA_API);
+
+// The same counters in Insights, running totals
+TRACE_DECLARE_INT_COUNTER_EXTERN(TBS_BFSNodes);
+TRACE_DECLARE_INT_COUNTER_EXTERN(TBS_SearchNodes);
+TRACE_DECLARE_INT_COUNTER_EXTERN(TBS_TilesTouched);
+TRACE_DECLARE_INT_COUNTER_EXTERN(TBS_TileListsBuilt);
+
+// Times the scope for `stat TBS` and as an event of the TBS trace channel
+#define TBS_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, TBSChannel)
+
+// Adds to a counter of both (TBS_BFSNodes updates STAT_TBS_BFSNodes)
+#define TBS_COUNTER_ADD(Counter, Amount) \
+	INC_DWORD_STAT_BY(STAT_##Counter, static_cast<uint32>(Amount)); \
+	TRACE_COUNTER_ADD(Counter, Amount)
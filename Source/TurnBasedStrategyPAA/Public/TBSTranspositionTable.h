@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TBSGameState.h"
+#include <atomic>
+
+// How a stored score relates to the true score of the position
+enum class ETBSBound : uint8
+{
+	None,
+	Exact,
+	// The true score is at least this (the search failed high)
+	Lower,
+	// The true score is at most this (the search failed low)
+	Upper
+};
+
+// What the table remembers of a searched position
+struct FTBSTableEntry
+{
+	int32 Score = 0;
+	int32 Depth = 0;
+	ETBSBound Bound = ETBSBound::None;
+
+	// Best action found, if any was stored
+	bool bHasAction = false;
+	FTBSAction Action;
+};
+
+/**
+ * Fixed-size hash table of searched positions, keyed by FTBSGameState::GetKey.
+ * Every bucket has two slots: the first keeps the deepest result of the current search, the second always takes the newest one.
+ * Slots are read and written without locks: a slot holds Key ^ Data next to Data, so a torn write
+ * from another thread fails the key check instead of handing back mixed data.
+ */
+class TURNBASEDSTRATEGYPAA_API FTBSTranspositionTable
+{
+public:
+	FTBSTranspositionTable();
+
+	// Reallocates with the largest power of two number of buckets that fits in SizeMB, and clears
+	void Resize(const int32 SizeMB);
+
+	FORCEINLINE int32 GetSizeMB() const { return SizeMB; }
+
+	void Clear();
+
+	// Marks the entries of earlier searches as replaceable
+	void NewSearch();
+
+	// Looks a position up, false if it isn't stored
+	bool Probe(const uint64 Key, FTBSTableEntry& OutEntry) const;
+
+	// Stores the result of a search of Depth actions from a position
+	void Store(const uint64 Key, const int32 Score, const int32 Depth, const ETBSBound Bound, const FTBSAction& Action);
+
+private:
+	struct FSlot
+	{
+		std::atomic<uint64> Check{ 0 };
+		std::atomic<uint64> Data{ 0 };
+	};
+
+	static uint64 PackEntry(const int32 Score, const int32 Depth, const ETBSBound Bound, const uint8 InGeneration, const FTBSAction& Action);
+	static void UnpackEntry(const uint64 Data, FTBSTableEntry& OutEntry);
+
+	TUniquePtr<FSlot[]> Slots;
+	uint64 BucketMask;
+	int32 SizeMB;
+
+	// Search counter, wraps around
+	uint8 Generation;
+};
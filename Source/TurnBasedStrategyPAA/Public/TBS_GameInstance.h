@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/GameInstance.h"
 #include "Unit.h"
+#include "TBSActionLog.h"
 #include "TBS_GameInstance.generated.h"
 
 /**
@@ -17,6 +18,30 @@ class TURNBASEDSTRATEGYPAA_API UTBS_GameInstance : public UGameInstance
 
 public:
 
+    // Move history notifications, so views only handle what changed
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnMoveHistoryAppended, int32, FirstLine, int32, NumLines);
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnMoveHistoryCleared);
+
+    UPROPERTY(BlueprintAssignable, Category = "Game History")
+    FOnMoveHistoryAppended OnMoveHistoryAppended;
+
+    UPROPERTY(BlueprintAssignable, Category = "Game History")
+    FOnMoveHistoryCleared OnMoveHistoryCleared;
+
+    // HUD notifications, fired only when the value actually changes so widgets don't poll every frame
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTurnMessageChanged, const FString&, Message);
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnScoresChanged, int32, HumanScore, int32, AIScore, int32, GamesPlayed);
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRoundChanged, int32, Round);
+
+    UPROPERTY(BlueprintAssignable, Category = "Game UI")
+    FOnTurnMessageChanged OnTurnMessageChanged;
+
+    UPROPERTY(BlueprintAssignable, Category = "Game Statistics")
+    FOnScoresChanged OnScoresChanged;
+
+    UPROPERTY(BlueprintAssignable, Category = "Game Statistics")
+    FOnRoundChanged OnRoundChanged;
+
     // Score values
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Game Statistics")
     int32 ScoreHumanPlayer = 0;
@@ -36,9 +61,8 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game Statistics")
     int32 TotalGamesPlayed = 0;
 
-    // Move history
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game History")
-    TArray<FString> MoveHistory;
+    // Move history of the current round, turned into text only when shown
+    FTBSActionLog ActionLog;
 
     // Functions to manage scores
     UFUNCTION(BlueprintCallable, Category = "Game Statistics")
@@ -71,14 +95,17 @@ public:
     void SetTurnMessage(const FString& Message);
 
     // Functions to manage move history
-    UFUNCTION(BlueprintCallable, Category = "Game History")
-    void AddMoveToHistory(int32 PlayerIndex, const FString& UnitType, const FString& ActionType, const FVector2D& FromPosition, const FVector2D& ToPosition, int32 Damage);
+    void AddMoveToHistory(const FTBSLogRecord& Record);
 
     UFUNCTION(BlueprintCallable, Category = "Game History")
     void ClearMoveHistory();
 
     UFUNCTION(BlueprintCallable, Category = "Game History")
-    FString GetFormattedMoveHistory() const;
+    int32 GetNumMoveHistoryLines() const;
+
+    // A single line, UMoveHistoryWidget only formats the lines on screen
+    UFUNCTION(BlueprintCallable, Category = "Game History")
+    FString GetMoveHistoryLine(int32 LineIndex) const;
 
     // Functions to update game statistics
     UFUNCTION(BlueprintCallable, Category = "Game Statistics")
@@ -96,4 +123,11 @@ public:
 
     int32 CurrentWinner = -1; // -1 means no winner yet
 
+    // Broadcasts the current values, e.g. for a widget that just bound to the events
+    UFUNCTION(BlueprintCallable, Category = "Game UI")
+    void BroadcastAllChanges();
+
+private:
+    void BroadcastScores();
+
 };
\ No newline at end of file
@@ -7,6 +7,10 @@
 #include "Unit.h"
 #include "Grid.h"
 #include "TBS_PlayerInterface.h"
+#include "MapGenerator.h"
+#include "TBSGameState.h"
+#include "TBSRandom.h"
+#include "TBSActionLog.h"
 #include "TBS_GameMode.generated.h"
 
 // Define an enum for game phases
@@ -20,6 +24,16 @@ enum class EGamePhase : uint8
 	ROUND_END		UMETA(DisplayName = "Round End")
 };
 
+// Live units of one player
+USTRUCT()
+struct FPlayerUnits
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TArray<AUnit*> Units;
+};
+
 /**
  * Game Mode for the game
  */
@@ -80,6 +94,29 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Game Rules") // implementare un limite?
 		float ObstaclePercentage;
 
+	// Seed of the first map, the following rounds use the next seeds (0 = random)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Game Rules")
+	int32 MapSeed;
+
+	// Maps generated ahead of time
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Game Rules")
+	int32 MapPoolSize;
+
+	// Seed of the map being played, generating it again gives the same layout
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game Rules")
+	int32 CurrentMapSeed;
+
+	// Seed of every random stream of the match: maps, coin tosses, damage and AI choices (0 = random)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Game Rules")
+	int32 MatchSeed;
+
+	// Seed the match is being played with, setting it as MatchSeed replays the same match
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Game Rules")
+	int32 CurrentMatchSeed;
+
+	// Random streams of the match, every random choice of the game draws from one of them
+	FORCEINLINE FTBSMatchRandom& GetMatchRandom() { return MatchRandom; }
+
 	// Types of units
 	UPROPERTY(EditDefaultsOnly, Category = "Playing Units")
 	TSubclassOf<AUnit> BrawlerClass;
@@ -110,6 +147,13 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "AI")
 	TSubclassOf<AActor> SmartAIClass;
 
+	// Hard AI planning with Monte Carlo tree search instead of alpha-beta
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool bUseMCTSAI;
+
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	TSubclassOf<AActor> MCTSAIClass;
+
 	// UI Widget related functions
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "UI")
 	TSubclassOf<UUserWidget> UnitSelectionWidgetClass;
@@ -209,6 +253,30 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Game Flow")
 	void NotifyUnitDestroyed(int32 PlayerIndex);
 
+	// Units add themselves when placed and leave when they die or are destroyed
+	void RegisterUnit(AUnit* Unit);
+	void UnregisterUnit(AUnit* Unit);
+
+	// Live units of a player (empty for an unknown player)
+	const TArray<AUnit*>& GetPlayerUnits(int32 PlayerIndex) const;
+
+	// Live units of every other player
+	void GetEnemyUnits(int32 PlayerIndex, TArray<AUnit*>& OutUnits) const;
+
+	// Number of live units of a player
+	UFUNCTION(BlueprintCallable, Category = "Playing Units")
+	int32 GetNumUnits(int32 PlayerIndex) const;
+
+	// Empties the registry, one slot per player
+	void ResetUnitRegistry();
+
+	// Copies the board and the live units into a game model, OutUnits[i] is the actor of model unit i
+	bool CaptureGameState(FTBSGameState& OutState, TArray<AUnit*>& OutUnits) const;
+
+	// Live units indexed by player, kept in sync with UnitsRemaining
+	UPROPERTY(Transient)
+	TArray<FPlayerUnits> UnitRegistry;
+
 	// Get the current player
 	UFUNCTION(BlueprintCallable, Category = "Game Flow")
 	AActor* GetCurrentPlayer();
@@ -221,17 +289,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Game Flow")
 	void ResetForNewRound(int32 WinnerIndex);
 
-	// Record a move to the game instance
-	UFUNCTION(BlueprintCallable, Category = "Game History")
-	void RecordMove(int32 PlayerIndex, FString UnitType, FString ActionType,
-		FVector2D FromPosition, FVector2D ToPosition, int32 Damage);
+	// Record a move to the game instance (attacks that dealt no damage didn't happen and are left out)
+	void RecordMove(int32 PlayerIndex, AUnit* Unit, ETBSLogAction Action,
+		FVector2D FromPosition, FVector2D ToPosition, int32 Damage = 0);
 
-	// Checks if placing an obstacle at the given position would break connectivity
-	bool WouldBreakConnectivity(int32 GridX, int32 GridY);
+	// Action log of the current round, kept by the game instance
+	FTBSActionLog* GetActionLog() const;
+
+	// Writes the action log of the current round to Saved/Replays, FTBSReplay plays it back
+	UFUNCTION(Exec, BlueprintCallable, Category = "Game History")
+	void SaveReplay();
 
 	// Modified SpawnObstacles function to ensure connectivity
 	void SpawnObstaclesWithConnectivity();
 
+	// Configures the map pool for the current grid and starts filling it
+	void PrepareMapPool();
+
+	// Obstacle layouts generated on worker threads
+	TSharedPtr<FMapPool, ESPMode::ThreadSafe> MapPool;
+
+	// Seeded in BeginPlay, shared by all the rounds of the match
+	FTBSMatchRandom MatchRandom;
+
 	// UserWidget for the End Turn Button
 	UPROPERTY(EditDefaultsOnly, Category = "UI")
 	TSubclassOf<UUserWidget> EndTurnButtonWidgetClass;
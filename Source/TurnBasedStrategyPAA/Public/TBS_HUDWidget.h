@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "TBS_HUDWidget.generated.h"
+
+class AUnit;
+class ATBS_HumanPlayer;
+class UMoveHistoryWidget;
+class UProgressBar;
+class UTextBlock;
+
+/**
+ * Base class of the in-game HUD (HUD_TBS). Every text is set from the game instance, human player and unit
+ * events when its value changes, nothing is bound to a getter polled every frame. The move history is a
+ * UMoveHistoryWidget fed line by line from the game instance's action log.
+ */
+UCLASS(Abstract)
+class TURNBASEDSTRATEGYPAA_API UTBS_HUDWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidget), Category = "Game History")
+    UMoveHistoryWidget* MoveHistory;
+
+    // Game instance values
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Game UI")
+    UTextBlock* PlayerTurn;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Game Statistics")
+    UTextBlock* PlayerScore;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Game Statistics")
+    UTextBlock* AIScore;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Game Statistics")
+    UTextBlock* TotalGamesCounter;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Game Statistics")
+    UTextBlock* TurnCounter;
+
+    // Human player's selection message
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "UI")
+    UTextBlock* SelectedUnit;
+
+    // Last clicked unit
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Unit Info")
+    UTextBlock* UnitSelected;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Unit Info")
+    UTextBlock* HpLiveCount;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Unit Info")
+    UProgressBar* UnitsHealthBar;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Unit Info")
+    UTextBlock* InfoDamage;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Unit Info")
+    UTextBlock* InfoMovement;
+
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional), Category = "Unit Info")
+    UTextBlock* InfoRange;
+
+protected:
+    virtual void NativeConstruct() override;
+    virtual void NativeDestruct() override;
+
+    UFUNCTION()
+    void OnTurnMessageChanged(const FString& Message);
+
+    UFUNCTION()
+    void OnScoresChanged(int32 HumanScore, int32 AIScoreValue, int32 GamesPlayed);
+
+    UFUNCTION()
+    void OnRoundChanged(int32 Round);
+
+    UFUNCTION()
+    void OnSelectionMessageChanged(const FString& Message);
+
+    UFUNCTION()
+    void OnLastClickedUnitChanged(AUnit* Unit);
+
+    UFUNCTION()
+    void OnUnitHealthChanged(AUnit* Unit, int32 Health, int32 MaxHealth);
+
+    // The game mode may spawn a new human player and possess it after the HUD is created
+    UFUNCTION()
+    void OnPossessedPawnChanged(APawn* OldPawn, APawn* NewPawn);
+
+private:
+    // Moves the player and unit bindings to another human player, nullptr to only unbind
+    void BindHumanPlayer(ATBS_HumanPlayer* Player);
+
+    // Moves the health binding to another unit and fills the unit info, nullptr to clear it
+    void BindUnit(AUnit* Unit);
+
+    TWeakObjectPtr<ATBS_HumanPlayer> BoundPlayer;
+
+    TWeakObjectPtr<AUnit> BoundUnit;
+};
@@ -32,6 +32,17 @@ public:
 	// Sets default values for this pawn's properties
 	ATBS_HumanPlayer();
 
+	// HUD notifications, fired only when the value changes so widgets don't poll every frame
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSelectionMessageChanged, const FString&, Message);
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnLastClickedUnitChanged, AUnit*, Unit);
+
+	UPROPERTY(BlueprintAssignable, Category = "UI")
+	FOnSelectionMessageChanged OnSelectionMessageChanged;
+
+	// Bind the unit's OnHealthChanged here for its health bar
+	UPROPERTY(BlueprintAssignable, Category = "Unit Info")
+	FOnLastClickedUnitChanged OnLastClickedUnitChanged;
+
 	// camera component attacched to player pawn
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UCameraComponent* Camera;
@@ -151,7 +162,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gameplay")
 	void ClearHighlightedTiles();
 
-	// UI Selection Detector
+	// UI Selection Detector, the message last sent to OnSelectionMessageChanged
 	UFUNCTION(BlueprintCallable, Category = "UI")
 	FString GetSelectionMessage() const;
 
@@ -159,4 +170,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gameplay")
 	void ForceEndTurn();
 
+private:
+	// Rebuilds the selection message and broadcasts it if it changed, called after every selection or action change
+	void RefreshSelectionMessage();
+
+	// Formats the message for the current turn, selection and action
+	FString BuildSelectionMessage() const;
+
+	void SetLastClickedUnit(AUnit* Unit);
+
+	// Grid of the game mode, nullptr before it is spawned
+	AGrid* GetGrid() const;
+
+	// Last message sent to OnSelectionMessageChanged
+	FString SelectionMessage;
+
 };
\ No newline at end of file
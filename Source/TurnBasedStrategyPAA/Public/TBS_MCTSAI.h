@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TBS_SmartAI.h"
+#include "TBS_MCTSAI.generated.h"
+
+/**
+ * Smart AI that plans with a Monte Carlo tree search instead of alpha-beta.
+ * The rolls are simulated instead of averaged, so it weighs risky attacks by their odds.
+ */
+UCLASS()
+class TURNBASEDSTRATEGYPAA_API ATBS_MCTSAI : public ATBS_SmartAI
+{
+    GENERATED_BODY()
+
+public:
+    // Sets default values for this pawn's properties
+    ATBS_MCTSAI();
+
+protected:
+    virtual void LaunchSearch(const FTBSGameState& State) override;
+
+    // Thinking time of a single search, in seconds
+    UPROPERTY(EditAnywhere, Category = "AI|Monte Carlo", meta = (ClampMin = "0.01"))
+    float MonteCarloTimeBudget;
+
+    // Trees searched in parallel, 0 for one per core
+    UPROPERTY(EditAnywhere, Category = "AI|Monte Carlo", meta = (ClampMin = "0"))
+    int32 NumTrees;
+
+    // UCT exploration constant, higher tries more alternatives
+    UPROPERTY(EditAnywhere, Category = "AI|Monte Carlo", meta = (ClampMin = "0.0"))
+    float Exploration;
+
+    // Turns played by a rollout before the position is scored
+    UPROPERTY(EditAnywhere, Category = "AI|Monte Carlo", meta = (ClampMin = "1"))
+    int32 RolloutTurns;
+};
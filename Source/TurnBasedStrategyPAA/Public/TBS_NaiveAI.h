@@ -91,6 +91,9 @@ protected:
 	// Handle unit attack
 	bool TryAttackWithUnit(AUnit* Unit);
 
+	// Stream of this AI in the match random streams, all its random choices come from it
+	class FTBSRandom& GetRandom() const;
+
 	// Pick a random tile for unit placement
 	bool PickRandomTileForPlacement(int32& OutX, int32& OutY);
 
@@ -7,6 +7,7 @@
 #include "TBS_PlayerInterface.h"
 #include "Unit.h"
 #include "Tile.h"
+#include "TBSPlanner.h"
 #include "TBS_SmartAI.generated.h"
 
 // Forward declarations
@@ -54,6 +55,9 @@ protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
 
+    // Drops the pending plan and timers
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     // Random delay between AI actions
     UPROPERTY(EditAnywhere, Category = "AI")
     float MinActionDelay;
@@ -61,6 +65,18 @@ protected:
     UPROPERTY(EditAnywhere, Category = "AI")
     float MaxActionDelay;
 
+    // Plan whole turns with a lookahead search instead of scoring each unit on its own
+    UPROPERTY(EditAnywhere, Category = "AI")
+    bool bUseSearch;
+
+    // Thinking time of a single search, in seconds
+    UPROPERTY(EditAnywhere, Category = "AI", meta = (EditCondition = "bUseSearch", ClampMin = "0.01"))
+    float SearchTimeBudget;
+
+    // Search depth limit, in actions (moves, attacks and ends of turn)
+    UPROPERTY(EditAnywhere, Category = "AI", meta = (EditCondition = "bUseSearch", ClampMin = "1", ClampMax = "31"))
+    int32 SearchMaxDepth;
+
     // Handle for the timer that controls the AI's thinking time
     FTimerHandle ActionTimerHandle;
 
@@ -92,9 +108,6 @@ protected:
     // Executes a move for a single unit
     void ProcessUnitAction(AUnit* Unit);
 
-    // A* Pathfinding implementation
-    TArray<ATile*> FindPathAStar(ATile* StartTile, ATile* GoalTile);
-
     // Handle unit movement using A*
     bool TryMoveUnit(AUnit* Unit);
 
@@ -107,6 +120,9 @@ protected:
     // Determine the best movement destination for a unit
     ATile* SelectBestMovementDestination(AUnit* Unit);
 
+    // Stream of this AI in the match random streams, all its random choices come from it
+    class FTBSRandom& GetRandom() const;
+
     // Pick a random tile for unit placement (same as NaiveAI)
     bool PickRandomTileForPlacement(int32& OutX, int32& OutY);
 
@@ -115,17 +131,50 @@ protected:
     void ProcessTurnAction();
     void FinishTurn();
 
-    // Helper struct for A* algorithm
-    struct FAStarNode
-    {
-        ATile* Tile;
-        float GScore; // Cost from start to this node
-        float FScore; // GScore + HScore (estimated cost to goal)
-        FAStarNode* Parent;
-
-        FAStarNode() : Tile(nullptr), GScore(FLT_MAX), FScore(FLT_MAX), Parent(nullptr) {}
-        FAStarNode(ATile* InTile) : Tile(InTile), GScore(FLT_MAX), FScore(FLT_MAX), Parent(nullptr) {}
-    };
+    // Route the unit toward the closest enemy it can't reach this turn, null if none
+    ATile* SelectApproachDestination(AUnit* Unit);
+
+    // Cells of the last path found, reused between queries
+    TArray<int32> PathCells;
+
+    // Plan phase: snapshots the match and starts the search on a worker thread
+    void StartPlanning();
+
+    // Hands the snapshot to the planner, subclasses pick the search engine
+    virtual void LaunchSearch(const FTBSGameState& State);
+
+    // Picks up the plan once the worker is done
+    void PollPlan();
+
+    // Apply phase: executes the next planned action on the game thread, one per timer tick
+    void ApplyNextPlannedAction();
+
+    // Executes a planned action on the real units, false if it isn't possible anymore
+    bool ApplySearchAction(const FTBSAction& Action);
+
+    // Greedy turn, one unit per timer tick
+    void ProcessNextUnit();
+
+    // Background search engine
+    TSharedPtr<FTBSPlanner, ESPMode::ThreadSafe> Planner;
+
+    // Snapshot of the last planning and the actors behind its units
+    FTBSGameState SearchState;
+
+    UPROPERTY()
+    TArray<AUnit*> SearchUnits;
+
+    // Plan being applied and the next action to apply
+    TArray<FTBSAction> PendingPlan;
+    int32 NextPlanAction;
+
+    // Searches started this turn
+    int32 NumSearchesThisTurn;
+
+    // Units still to play in a greedy turn
+    UPROPERTY()
+    TArray<AUnit*> PendingUnits;
+    int32 NextPendingUnit;
 
     // Manhattan distance
     float CalculateHeuristic(const FVector2D& Start, const FVector2D& Goal) const;
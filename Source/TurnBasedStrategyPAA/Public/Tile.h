@@ -7,6 +7,7 @@
 #include "Tile.generated.h"
 
 class AUnit;
+class AGrid;
 
 UENUM()
 enum class ETileStatus : uint8
@@ -15,6 +16,17 @@ enum class ETileStatus : uint8
 	OCCUPIED      UMETA(DisplayName = "Occupied"),
 };
 
+// Look of a tile drawn by the grid's instanced mesh
+UENUM(BlueprintType)
+enum class ETileVisual : uint8
+{
+	GROUND		  UMETA(DisplayName = "Ground"),
+	OBSTACLE      UMETA(DisplayName = "Obstacle"),
+	MOVEMENT      UMETA(DisplayName = "Movement"),
+	ATTACK        UMETA(DisplayName = "Attack"),
+	SELECTION     UMETA(DisplayName = "Selection"),
+};
+
 UCLASS()
 class TURNBASEDSTRATEGYPAA_API ATile : public AActor
 {
@@ -39,6 +51,12 @@ public:
 	// get the (x, y) position
 	FVector2D GetGridPosition();
 
+	// attach the tile to the board cell it represents
+	void BindToGrid(AGrid* InGrid, const int32 InCellIndex);
+
+	// get the row-major index of the tile in the grid
+	FORCEINLINE int32 GetCellIndex() const { return CellIndex; }
+
 	// Set the occupying unit
 	void SetOccupyingUnit(AUnit* Unit);
 
@@ -64,6 +82,9 @@ public:
 
 	void ClearHighlight();
 
+	// Draws the highlight the grid resolved for this tile (GROUND restores the tile), actor tiles only
+	void DrawHighlight(const ETileVisual Visual);
+
 	// Check if this tile is an obstacle
 	bool IsObstacle() const;
 
@@ -91,6 +112,13 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	AUnit* OccupyingUnit;
 
+	// Grid owning the board state this tile is a view of
+	UPROPERTY(Transient)
+	AGrid* Grid;
+
+	// Index of the tile's cell in the grid
+	int32 CellIndex;
+
 	UMaterialInterface* OriginalMaterial;
 	bool bIsHighlighted;
 
@@ -46,6 +46,12 @@ public:
     // Sets default values for this actor's properties
     AUnit();
 
+    // Fired when the unit's health changes, so health bars update without polling
+    DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOnUnitHealthChanged, AUnit*, Unit, int32, Health, int32, MaxHealth);
+
+    UPROPERTY(BlueprintAssignable, Category = "Unit")
+    FOnUnitHealthChanged OnHealthChanged;
+
     // Set the unit's owner
     void SetOwnerID(int32 InOwnerID);
 
@@ -77,6 +83,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Unit")
     int32 GetAttackRange() const;
 
+    // Get unit's Movement Range
+    UFUNCTION(BlueprintCallable, Category = "Unit")
+    int32 GetMovementRange() const;
+
     // Get unit's min and max damage
     UFUNCTION(BlueprintCallable, Category = "Unit")
     int32 GetMinDamage() const;
@@ -88,7 +98,7 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Unit")
     float GetAverageAttackDamage() const;
 
-    // Get unit's health/max health
+    // Get unit's health/max health, formatted when the health changes rather than on every call
     UFUNCTION(BlueprintCallable, Category = "Unit")
     FString GetLiveHealth();
 
@@ -109,14 +119,28 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Unit")
     TArray<ATile*> GetMovementTiles();
 
+    // True if the unit can walk to the tile this turn, constant time
+    UFUNCTION(BlueprintCallable, Category = "Unit")
+    bool CanMoveToTile(ATile* Tile);
+
+    // Cells within walking distance, the grid's cached field for the current board; null if the unit is not on the board
+    const FGridDistanceField* GetMovementField();
+
     // Highlight the tiles within attack range
     UFUNCTION(BlueprintCallable, Category = "Unit")
     TArray<ATile*> GetAttackTiles();
 
+    // True if the target is an enemy within attack range
+    UFUNCTION(BlueprintCallable, Category = "Unit")
+    bool CanAttack(AUnit* TargetUnit);
+
     // Attack action
     UFUNCTION(BlueprintCallable, Category = "Unit")
     virtual int32 Attack(AUnit* TargetUnit);
 
+    // Counter-damage the last attack of this unit took, 0 if none
+    int32 GetLastCounterDamage() const { return LastCounterDamage; }
+
     // Damage received
     UFUNCTION(BlueprintCallable, Category = "Unit")
     void ReceiveDamage(int32 DamageAmount);
@@ -152,11 +176,37 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Unit Appearance")
     virtual void UpdateAppearanceByTeam();
 
+    // Slot in the game mode's unit registry, INDEX_NONE when not registered
+    int32 RegistryIndex;
 
 protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
 
+    // Leaves the unit registry if the unit is removed without dying
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // True if the cell holds an enemy unit (obstacles are "occupied" but never attackable)
+    bool IsAttackableCell(const int32 Index) const;
+
+    // Cell of an enemy unit standing on the board, INDEX_NONE if it can't be attacked
+    int32 GetAttackableIndex(AUnit* Unit) const;
+
+    // Uniform damage in [Min, Max] from the match combat stream
+    int32 RollDamage(int32 Min, int32 Max) const;
+
+    // Set by Attack for the action log
+    int32 LastCounterDamage;
+
+    // "Hp: Health / MaxHealth", rebuilt by UpdateLiveHealthText
+    FString LiveHealthText;
+
+    void UpdateLiveHealthText();
+
+    // Reachable area of the last movement query, shared by highlighting, click checks and the move itself;
+    // points into the grid's distance cache, valid while the entry still matches the query
+    const FGridDistanceField* MovementField = nullptr;
+
     // To add visuals to the scene
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     USceneComponent* SceneComponent;